@@ -0,0 +1,107 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include <dst/binary_tree/concurrent_set.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>    // std::uint32_t
+#include <functional> // std::hash
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace dst_bench
+{
+
+namespace
+{
+const int key_range = 2000000;
+
+// Xorshift, one per thread
+class key_generator
+{
+public:
+  key_generator()
+  : state_(2463534242u)
+  {
+    state_ ^= static_cast<std::uint32_t>(
+      std::hash<std::thread::id>()(std::this_thread::get_id()));
+  }
+
+  int operator()()
+  {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+
+    return static_cast<int>(state_ % key_range);
+  }
+
+private:
+  std::uint32_t state_;
+};
+
+// Every other key of the range, shared by the runs with all thread counts
+template <typename Set> Set& half_full_set()
+{
+  static Set set;
+  static std::once_flag filled;
+
+  std::call_once(filled, []() {
+    for (int key = 0; key < key_range; key += 2)
+    {
+      set.insert(key);
+    }
+  });
+
+  return set;
+}
+
+// Half of the operations insert a random key, half erase one, so the set
+// stays at about half of the key range.
+void bench_concurrent_insert_erase(benchmark::State& state)
+{
+  auto& set = half_full_set<dst::binary_tree::concurrent_set<int>>();
+
+  key_generator keys;
+
+  for (auto _ : state)
+  {
+    set.insert(keys());
+    set.erase(keys());
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// Baseline: std::set behind one mutex.
+void bench_locked_insert_erase(benchmark::State& state)
+{
+  auto& set = half_full_set<std::set<int>>();
+
+  static std::mutex mutex;
+
+  key_generator keys;
+
+  for (auto _ : state)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      set.insert(keys());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    set.erase(keys());
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+}
+
+BENCHMARK(bench_concurrent_insert_erase)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(bench_locked_insert_erase)->ThreadRange(1, 32)->UseRealTime();
+
+} // dst_bench
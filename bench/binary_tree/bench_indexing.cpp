@@ -0,0 +1,146 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include "tools/bench_utility.h"
+
+#include <dst/allocator/arena_allocator.h>
+#include <dst/binary_tree/blocked_list.h>
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+#include <dst/binary_tree/mixin/splay.h>
+
+#include <boost/container/flat_set.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <deque>
+#include <iterator> // std::distance
+#include <vector>
+
+namespace dst_bench
+{
+
+namespace
+{
+using indexed_list = dst::binary_tree::list<int,
+                                            std::allocator<int>,
+                                            dst::binary_tree::Indexing,
+                                            dst::binary_tree::AVL>;
+
+using arena_indexed_list = dst::binary_tree::list<int,
+                                                  dst::arena_allocator<int>,
+                                                  dst::binary_tree::Indexing,
+                                                  dst::binary_tree::AVL>;
+
+using splay_list = dst::binary_tree::list<int,
+                                          std::allocator<int>,
+                                          dst::binary_tree::Indexing,
+                                          dst::binary_tree::Splay>;
+
+using blocked_list = dst::binary_tree::blocked_list<int>;
+
+using flat_set = boost::container::flat_set<int>;
+
+template <typename Container> void bench_element_at(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<Container>(n);
+  random_indices indices(n);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(*nth(c, indices()));
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Lookups stay within a window of 32 elements which moves every 1024 lookups
+template <typename Container>
+void bench_skewed_element_at(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<Container>(n);
+  random_indices centers(n - 32);
+  random_indices offsets(32);
+
+  std::size_t center = centers();
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(*nth(c, center + offsets()));
+
+    if (++i % 1024 == 0)
+      center = centers();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Container, typename Iterator>
+std::size_t index_of(const Container& c, Iterator it)
+{
+  return c.index(it);
+}
+
+template <typename Iterator>
+std::size_t index_of(const flat_set& c, Iterator it)
+{
+  return c.index_of(it);
+}
+
+template <typename T, typename Iterator>
+std::size_t index_of(const std::vector<T>& c, Iterator it)
+{
+  return static_cast<std::size_t>(std::distance(c.begin(), it));
+}
+
+template <typename Container> void bench_index(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  const auto c = make_container<Container>(n);
+  random_indices indices(n);
+
+  std::vector<typename Container::const_iterator> positions;
+  for (std::size_t i = 0; i < 4096; ++i)
+  {
+    positions.push_back(nth(c, indices()));
+  }
+
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(index_of(c, positions[i]));
+
+    i = (i + 1) % positions.size();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+}
+
+BENCHMARK_TEMPLATE(bench_element_at, indexed_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_element_at, arena_indexed_list)
+  ->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_element_at, blocked_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_element_at, std::vector<int>)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_element_at, std::deque<int>)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_element_at, flat_set)->Apply(container_sizes);
+
+BENCHMARK_TEMPLATE(bench_skewed_element_at, indexed_list)
+  ->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_skewed_element_at, splay_list)
+  ->Apply(container_sizes);
+
+BENCHMARK_TEMPLATE(bench_index, indexed_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_index, arena_indexed_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_index, blocked_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_index, std::vector<int>)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_index, flat_set)->Apply(container_sizes);
+
+} // dst_bench
@@ -0,0 +1,521 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include "tools/bench_utility.h"
+
+#include <dst/binary_tree/blocked_list.h>
+#include <dst/binary_tree/concurrent_list.h>
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+#include <dst/binary_tree/mixin/rb.h>
+#include <dst/binary_tree/mixin/threading.h>
+#include <dst/binary_tree/mixin/treap.h>
+#include <dst/binary_tree/mixin/wb.h>
+#include <dst/binary_tree/parallel_algorithm.h>
+#include <dst/binary_tree/persistent_list.h>
+
+#include <boost/container/flat_set.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <deque>
+#include <iterator> // std::next
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dst_bench
+{
+
+namespace
+{
+using avl_list = dst::binary_tree::list<int>;
+
+using indexed_list = dst::binary_tree::list<int,
+                                            std::allocator<int>,
+                                            dst::binary_tree::Indexing,
+                                            dst::binary_tree::AVL>;
+
+using rb_list = dst::binary_tree::list<int,
+                                       std::allocator<int>,
+                                       dst::binary_tree::Indexing,
+                                       dst::binary_tree::RB>;
+
+using wb_list = dst::binary_tree::list<int,
+                                       std::allocator<int>,
+                                       dst::binary_tree::Indexing,
+                                       dst::binary_tree::WB>;
+
+using treap_list = dst::binary_tree::list<int,
+                                          std::allocator<int>,
+                                          dst::binary_tree::Indexing,
+                                          dst::binary_tree::Treap>;
+
+using threaded_list = dst::binary_tree::list<int,
+                                             std::allocator<int>,
+                                             dst::binary_tree::Threading,
+                                             dst::binary_tree::Indexing,
+                                             dst::binary_tree::AVL>;
+
+using blocked_list = dst::binary_tree::blocked_list<int>;
+
+using persistent_list = dst::binary_tree::persistent_list<int>;
+
+using flat_multiset = boost::container::flat_multiset<int>;
+
+template <typename Container> void bench_push_back(benchmark::State& state)
+{
+  const auto n = static_cast<int>(state.range(0));
+
+  for (auto _ : state)
+  {
+    Container c;
+
+    for (int i = 0; i < n; ++i)
+    {
+      c.push_back(i);
+    }
+
+    benchmark::DoNotOptimize(c);
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename Container> void bench_push_front(benchmark::State& state)
+{
+  const auto n = static_cast<int>(state.range(0));
+
+  for (auto _ : state)
+  {
+    Container c;
+
+    for (int i = 0; i < n; ++i)
+    {
+      c.push_front(i);
+    }
+
+    benchmark::DoNotOptimize(c);
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Inserts and erases at random positions, keeping the size constant.
+template <typename Container>
+void bench_random_insert_erase(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<Container>(n);
+  random_indices indices(n);
+
+  for (auto _ : state)
+  {
+    c.insert(nth(c, indices()), 0);
+    c.erase(nth(c, indices()));
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// Sorted containers place the element by value instead of by position.
+template <typename Container>
+void bench_random_insert_erase_sorted(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<Container>(n);
+  random_indices indices(n);
+
+  for (auto _ : state)
+  {
+    c.insert(static_cast<int>(indices()));
+    c.erase(nth(c, indices()));
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// 70% of the operations are insertions and erasures at random positions,
+// the rest are random lookups.
+template <typename Container>
+void bench_write_heavy_mix(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<Container>(n);
+  random_indices indices(n);
+
+  for (auto _ : state)
+  {
+    for (int k = 0; k < 20; ++k)
+    {
+      if (k < 6)
+        benchmark::DoNotOptimize(*nth(c, indices()));
+      else if (k % 2 == 0)
+        c.insert(nth(c, indices()), 0);
+      else
+        c.erase(nth(c, indices()));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * 20);
+}
+
+// Moves a random range of 1 to n / 2 elements to another random position
+// with two splits, a join and a splice.
+template <typename Container>
+void bench_cut_and_paste(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<Container>(n);
+  random_indices indices(n / 2);
+
+  for (auto _ : state)
+  {
+    const auto from = indices();
+
+    auto tail = c.split(nth(c, from + 1 + indices()));
+    auto middle = c.split(nth(c, from));
+
+    c.join(tail);
+    c.splice(nth(c, indices()), middle);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Erases and reinserts the second element. Without Indexing, erasing a
+// range must not count the elements after it.
+template <typename Container>
+void bench_erase_short_range(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<Container>(n);
+
+  for (auto _ : state)
+  {
+    c.erase(std::next(c.cbegin()), std::next(c.cbegin(), 2));
+    c.insert(std::next(c.cbegin()), 0);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Container> void bench_copy(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  const auto c = make_container<Container>(n);
+
+  for (auto _ : state)
+  {
+    Container copy(c);
+
+    benchmark::DoNotOptimize(copy);
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename Container> void bench_clear(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  const auto c = make_container<Container>(n);
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    Container copy(c);
+    state.ResumeTiming();
+
+    copy.clear();
+
+    benchmark::DoNotOptimize(copy);
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Element counts from 1e5 to 1e7 and 1 to 8 threads. Real time, because the
+// workers do not show up in the CPU time of the main thread.
+void parallel_sizes(benchmark::internal::Benchmark* b)
+{
+  for (int n = 100000; n <= 10000000; n *= 10)
+  {
+    for (int threads = 1; threads <= 8; threads *= 2)
+    {
+      b->Args({n, threads});
+    }
+  }
+
+  b->UseRealTime();
+}
+
+template <typename Container> void bench_parallel_copy(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<Container>(n);
+
+  c.set_parallel_policy(dst::binary_tree::parallel_policy(
+    static_cast<unsigned>(state.range(1)), 0));
+
+  for (auto _ : state)
+  {
+    Container copy(c);
+
+    benchmark::DoNotOptimize(copy);
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename Container> void bench_parallel_clear(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<Container>(n);
+
+  c.set_parallel_policy(dst::binary_tree::parallel_policy(
+    static_cast<unsigned>(state.range(1)), 0));
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    Container copy(c);
+    state.ResumeTiming();
+
+    copy.clear();
+
+    benchmark::DoNotOptimize(copy);
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename Container>
+void bench_parallel_reduce(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  const auto c = make_container<Container>(n);
+
+  const dst::binary_tree::parallel_policy policy(
+    static_cast<unsigned>(state.range(1)), 0);
+
+  for (auto _ : state)
+  {
+    auto sum = dst::binary_tree::parallel_reduce(
+      c, 0ll, [](long long lhs, long long rhs) { return lhs + rhs; }, policy);
+
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Random reads while another thread keeps replacing elements, if the second
+// argument is 1.
+void bench_concurrent_read(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  dst::binary_tree::concurrent_list<int> c;
+
+  c.update([n](dst::binary_tree::concurrent_list<int>::list_type& l) {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      l.push_back(static_cast<int>(i));
+    }
+  });
+
+  std::atomic<bool> done(false);
+  std::thread writer;
+
+  if (state.range(1) != 0)
+  {
+    writer = std::thread([&c, &done, n]() {
+      random_indices indices(n);
+
+      for (int v = 0; !done.load(std::memory_order_relaxed); ++v)
+      {
+        c.set(indices(), v);
+      }
+    });
+  }
+
+  random_indices indices(n);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(c.read()[indices()]);
+  }
+
+  done = true;
+
+  if (writer.joinable())
+    writer.join();
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Baseline: the same with a list behind a mutex.
+void bench_locked_read(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<indexed_list>(n);
+  std::mutex mutex;
+
+  std::atomic<bool> done(false);
+  std::thread writer;
+
+  if (state.range(1) != 0)
+  {
+    writer = std::thread([&c, &mutex, &done, n]() {
+      random_indices indices(n);
+
+      for (int v = 0; !done.load(std::memory_order_relaxed); ++v)
+      {
+        const auto k = indices();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        c[k] = v;
+      }
+    });
+  }
+
+  random_indices indices(n);
+
+  for (auto _ : state)
+  {
+    const auto k = indices();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    benchmark::DoNotOptimize(c[k]);
+  }
+
+  done = true;
+
+  if (writer.joinable())
+    writer.join();
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Element counts from 1e3 to 1e6, without and with a writer.
+void concurrent_sizes(benchmark::internal::Benchmark* b)
+{
+  for (int n = 1000; n <= 1000000; n *= 10)
+  {
+    b->Args({n, 0});
+    b->Args({n, 1});
+  }
+
+  b->UseRealTime();
+}
+
+template <typename Container> void bench_scan(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  const auto c = make_container<Container>(n);
+
+  for (auto _ : state)
+  {
+    long long sum = 0;
+
+    for (const auto v : c)
+    {
+      sum += v;
+    }
+
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+}
+
+BENCHMARK_TEMPLATE(bench_push_back, avl_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_push_back, indexed_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_push_back, blocked_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_push_back, std::vector<int>)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_push_back, std::deque<int>)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_push_back, std::list<int>)->Apply(container_sizes);
+
+BENCHMARK_TEMPLATE(bench_push_front, avl_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_push_front, indexed_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_push_front, std::deque<int>)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_push_front, std::list<int>)->Apply(container_sizes);
+
+BENCHMARK_TEMPLATE(bench_random_insert_erase, indexed_list)
+  ->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_random_insert_erase, rb_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_random_insert_erase, wb_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_random_insert_erase, treap_list)
+  ->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_random_insert_erase, blocked_list)
+  ->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_random_insert_erase, std::vector<int>)
+  ->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_random_insert_erase, std::deque<int>)
+  ->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_random_insert_erase, std::list<int>)
+  ->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_random_insert_erase_sorted, flat_multiset)
+  ->Apply(container_sizes);
+
+BENCHMARK_TEMPLATE(bench_write_heavy_mix, indexed_list)
+  ->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_write_heavy_mix, rb_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_write_heavy_mix, wb_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_write_heavy_mix, treap_list)->Apply(container_sizes);
+
+BENCHMARK_TEMPLATE(bench_cut_and_paste, indexed_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_cut_and_paste, wb_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_cut_and_paste, treap_list)->Apply(container_sizes);
+
+BENCHMARK_TEMPLATE(bench_erase_short_range, avl_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_erase_short_range, indexed_list)
+  ->Apply(container_sizes);
+
+BENCHMARK_TEMPLATE(bench_copy, avl_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_copy, indexed_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_copy, persistent_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_copy, std::vector<int>)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_copy, std::deque<int>)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_copy, std::list<int>)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_copy, flat_multiset)->Apply(container_sizes);
+
+BENCHMARK_TEMPLATE(bench_clear, avl_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_clear, indexed_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_clear, std::vector<int>)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_clear, std::deque<int>)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_clear, std::list<int>)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_clear, flat_multiset)->Apply(container_sizes);
+
+BENCHMARK_TEMPLATE(bench_parallel_copy, indexed_list)->Apply(parallel_sizes);
+BENCHMARK_TEMPLATE(bench_parallel_clear, indexed_list)->Apply(parallel_sizes);
+BENCHMARK_TEMPLATE(bench_parallel_reduce, indexed_list)->Apply(parallel_sizes);
+BENCHMARK_TEMPLATE(bench_parallel_reduce, avl_list)->Apply(parallel_sizes);
+
+BENCHMARK(bench_concurrent_read)->Apply(concurrent_sizes);
+BENCHMARK(bench_locked_read)->Apply(concurrent_sizes);
+
+BENCHMARK_TEMPLATE(bench_scan, avl_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_scan, threaded_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_scan, blocked_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_scan, std::vector<int>)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_scan, std::list<int>)->Apply(container_sizes);
+
+} // dst_bench
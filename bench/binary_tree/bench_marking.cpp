@@ -0,0 +1,241 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include "tools/bench_utility.h"
+
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+#include <dst/binary_tree/mixin/marking.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm> // std::sort, std::unique
+#include <iterator>  // std::next
+#include <utility>   // std::pair
+#include <vector>
+
+namespace dst_bench
+{
+
+namespace
+{
+using marked_list = dst::binary_tree::list<int,
+                                           std::allocator<int>,
+                                           dst::binary_tree::Indexing,
+                                           dst::binary_tree::Marking<>,
+                                           dst::binary_tree::AVL>;
+
+// Every 16th element is marked in the scanning benchmarks.
+const std::size_t mark_step = 16;
+
+void bench_mark(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<marked_list>(n);
+  random_indices indices(n);
+
+  std::vector<marked_list::const_iterator> positions;
+  for (std::size_t i = 0; i < 4096; ++i)
+  {
+    positions.push_back(c.element_at(indices()));
+  }
+
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    c.mark(positions[i]);
+    c.unmark(positions[i]);
+
+    i = (i + 1) % positions.size();
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// Number of elements marked at once in the batch benchmarks.
+const std::size_t batch_size = 1024;
+
+// Sizes from 1e3 to 1e7 elements, batches with stride 1, 16 and 1024.
+void batch_strides(benchmark::internal::Benchmark* b)
+{
+  for (int n = 1000; n <= 10000000; n *= 10)
+  {
+    for (const int stride : {1, 16, 1024})
+    {
+      b->Args({n, stride});
+    }
+  }
+}
+
+// Every `stride`-th element from the first third of `c` on, in order
+std::vector<marked_list::const_iterator>
+batch_positions(const marked_list& c, std::size_t stride)
+{
+  std::vector<std::size_t> indices;
+  for (std::size_t i = 0; i < batch_size; ++i)
+  {
+    indices.push_back((c.size() / 3 + i * stride) % c.size());
+  }
+
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+  std::vector<marked_list::const_iterator> positions;
+  for (const auto i : indices)
+  {
+    positions.push_back(c.element_at(i));
+  }
+
+  return positions;
+}
+
+void bench_mark_one_by_one(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<marked_list>(n);
+  const auto positions =
+    batch_positions(c, static_cast<std::size_t>(state.range(1)));
+
+  for (auto _ : state)
+  {
+    for (const auto& position : positions)
+    {
+      c.mark(position);
+    }
+
+    for (const auto& position : positions)
+    {
+      c.unmark(position);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2 * positions.size());
+}
+
+void bench_mark_batch(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<marked_list>(n);
+  const auto positions =
+    batch_positions(c, static_cast<std::size_t>(state.range(1)));
+
+  for (auto _ : state)
+  {
+    c.mark(positions.begin(), positions.end());
+    c.unmark(positions.begin(), positions.end());
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2 * positions.size());
+}
+
+void bench_mark_range(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<marked_list>(n);
+
+  const auto from = c.element_at(n / 3);
+  const auto to = std::next(from, batch_size);
+
+  for (auto _ : state)
+  {
+    c.mark_range(from, to);
+    c.unmark_range(from, to);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2 * batch_size);
+}
+
+void bench_marked_scan(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<marked_list>(n);
+
+  for (std::size_t i = 0; i < n; i += mark_step)
+  {
+    c.mark(c.element_at(i));
+  }
+
+  for (auto _ : state)
+  {
+    long long sum = 0;
+
+    for (auto it = c.begin_marked(); it != c.end_marked(); ++it)
+    {
+      sum += *it;
+    }
+
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * (n / mark_step));
+}
+
+// Random access to the k-th marked element and back to its index.
+void bench_marked_at(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<marked_list>(n);
+
+  for (std::size_t i = 0; i < n; i += mark_step)
+  {
+    c.mark(c.element_at(i));
+  }
+
+  random_indices indices(n / mark_step);
+
+  for (auto _ : state)
+  {
+    const auto it = c.marked_at(indices());
+
+    benchmark::DoNotOptimize(c.marked_index(it));
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// Baseline: a flag next to every element, filtered by a linear scan.
+void bench_flagged_vector_scan(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  std::vector<std::pair<int, bool>> c(n);
+
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    c[i] = std::make_pair(static_cast<int>(i), i % mark_step == 0);
+  }
+
+  for (auto _ : state)
+  {
+    long long sum = 0;
+
+    for (const auto& v : c)
+    {
+      if (v.second)
+        sum += v.first;
+    }
+
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * (n / mark_step));
+}
+}
+
+BENCHMARK(bench_mark)->Apply(container_sizes);
+BENCHMARK(bench_mark_one_by_one)->Apply(batch_strides);
+BENCHMARK(bench_mark_batch)->Apply(batch_strides);
+BENCHMARK(bench_mark_range)->Apply(container_sizes);
+BENCHMARK(bench_marked_scan)->Apply(container_sizes);
+BENCHMARK(bench_marked_at)->Apply(container_sizes);
+BENCHMARK(bench_flagged_vector_scan)->Apply(container_sizes);
+
+} // dst_bench
@@ -0,0 +1,184 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include "tools/bench_utility.h"
+
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+#include <dst/binary_tree/mixin/ordering.h>
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace dst_bench
+{
+
+namespace
+{
+using ordered_list = dst::binary_tree::list<int,
+                                            std::allocator<int>,
+                                            dst::binary_tree::Indexing,
+                                            dst::binary_tree::AVL,
+                                            dst::binary_tree::Ordering>;
+
+using labeled_list =
+  dst::binary_tree::list<int,
+                         std::allocator<int>,
+                         dst::binary_tree::Indexing,
+                         dst::binary_tree::AVL,
+                         dst::binary_tree::OrderMaintenance>;
+
+template <typename Container>
+std::vector<typename Container::const_iterator>
+random_positions(const Container& c, std::size_t n)
+{
+  random_indices indices(n);
+
+  std::vector<typename Container::const_iterator> positions;
+  for (std::size_t i = 0; i < 4096; ++i)
+  {
+    positions.push_back(nth(c, indices()));
+  }
+
+  return positions;
+}
+
+template <typename Container> void bench_order(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  const auto c = make_container<Container>(n);
+  const auto positions = random_positions(c, n);
+
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(
+      c.order(positions[i], positions[(i + 1) % positions.size()]));
+
+    i = (i + 1) % positions.size();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Insertions at one place, the worst case for order maintenance labels.
+template <typename Container>
+void bench_insert_at_one_place(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : state)
+  {
+    Container c;
+
+    const auto position = c.insert(c.cend(), 0);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      c.insert(position, static_cast<int>(i));
+    }
+
+    benchmark::DoNotOptimize(c.size());
+  }
+
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Insertions at one place into a large list. Once the list outgrows the
+// labels' density bound, running out of labels there relabels all of it.
+template <typename Container>
+void bench_insert_at_one_place_large(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<Container>(n);
+
+  const auto position = nth(c, n / 2);
+
+  for (auto _ : state)
+  {
+    c.insert(position, 0);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Splices four elements into the middle and erases them again. Only the
+// labels around the splice point should be rewritten.
+template <typename Container> void bench_splice_small(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  auto c = make_container<Container>(n);
+
+  for (auto _ : state)
+  {
+    Container other(4, 0, c.get_allocator());
+
+    const auto position = nth(c, n / 2);
+
+    c.splice(position, other);
+    c.erase(position - 4, position);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Baseline: comparing the indices of the elements.
+void bench_order_by_index(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  const auto c = make_container<ordered_list>(n);
+  const auto positions = random_positions(c, n);
+
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(
+      c.index(positions[i]) < c.index(positions[(i + 1) % positions.size()]));
+
+    i = (i + 1) % positions.size();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+void bench_order_vector(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  const auto c = make_container<std::vector<int>>(n);
+  const auto positions = random_positions(c, n);
+
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(positions[i] <
+                             positions[(i + 1) % positions.size()]);
+
+    i = (i + 1) % positions.size();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+}
+
+BENCHMARK_TEMPLATE(bench_order, ordered_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_order, labeled_list)->Apply(container_sizes);
+BENCHMARK_TEMPLATE(bench_insert_at_one_place, ordered_list)
+  ->Range(1000, 1000000);
+BENCHMARK_TEMPLATE(bench_insert_at_one_place, labeled_list)
+  ->Range(1000, 1000000);
+BENCHMARK_TEMPLATE(bench_insert_at_one_place_large, labeled_list)
+  ->RangeMultiplier(4)
+  ->Range(1 << 20, 1 << 25);
+BENCHMARK_TEMPLATE(bench_splice_small, labeled_list)->Apply(container_sizes);
+BENCHMARK(bench_order_by_index)->Apply(container_sizes);
+BENCHMARK(bench_order_vector)->Apply(container_sizes);
+
+} // dst_bench
@@ -0,0 +1,102 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>  // std::size_t
+#include <iterator> // std::next
+#include <numeric>  // std::iota
+#include <random>
+#include <vector>
+
+namespace dst_bench
+{
+
+// Sweeps the container size from 1e3 to 1e7 elements.
+inline void container_sizes(benchmark::internal::Benchmark* b)
+{
+  b->RangeMultiplier(10)->Range(1000, 10000000);
+}
+
+// Random indices in [0, n) drawn once, so that the generator does not
+// show up in the measured loop.
+class random_indices
+{
+public:
+  explicit random_indices(std::size_t n, std::size_t count = 4096)
+  : indices_(count)
+  , next_(0)
+  {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::size_t> distribution(0, n - 1);
+
+    for (auto& i : indices_)
+    {
+      i = distribution(generator);
+    }
+  }
+
+  std::size_t operator()()
+  {
+    const auto i = indices_[next_];
+
+    next_ = (next_ + 1) % indices_.size();
+
+    return i;
+  }
+
+private:
+  std::vector<std::size_t> indices_;
+  std::size_t next_;
+};
+
+template <typename Container> Container make_container(std::size_t n)
+{
+  std::vector<int> v(n);
+  std::iota(v.begin(), v.end(), 0);
+
+  return Container(v.begin(), v.end());
+}
+
+namespace detail
+{
+template <int N> struct priority : priority<N - 1>
+{
+};
+
+template <> struct priority<0>
+{
+};
+
+template <typename Container>
+auto nth(Container& c, std::size_t i, priority<2>) -> decltype(c.element_at(i))
+{
+  return c.element_at(i);
+}
+
+template <typename Container>
+auto nth(Container& c, std::size_t i, priority<1>) -> decltype(c.nth(i))
+{
+  return c.nth(i);
+}
+
+template <typename Container>
+auto nth(Container& c, std::size_t i, priority<0>) -> decltype(c.begin())
+{
+  return std::next(c.begin(), i);
+}
+}
+
+// Iterator to the `i`-th element, using the fastest access the container has.
+template <typename Container>
+auto nth(Container& c, std::size_t i)
+  -> decltype(detail::nth(c, i, detail::priority<2>()))
+{
+  return detail::nth(c, i, detail::priority<2>());
+}
+
+} // dst_bench
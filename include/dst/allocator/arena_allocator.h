@@ -0,0 +1,570 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include "utility.h"
+
+#include <atomic>       // std::atomic
+#include <cassert>      // assert
+#include <cstddef>      // std::size_t, std::ptrdiff_t, std::nullptr_t
+#include <cstdint>      // std::uint32_t
+#include <cstring>      // std::memcpy
+#include <forward_list> // std::forward_list
+#include <limits>       // std::numeric_limits
+#include <memory> // std::allocator, std::allocator_traits, std::shared_ptr
+#include <mutex>  // std::lock_guard, std::mutex, std::unique_lock
+#include <new>    // std::bad_alloc, std::launder
+#include <type_traits> // std::aligned_storage, std::remove_const
+
+namespace dst
+{
+
+namespace detail
+{
+
+namespace allocator
+{
+
+// Storage for objects of type `T`. Objects are addressed by 32-bit
+// references: the upper `id_bits` hold the id of the arena and the rest the
+// index of the slot in it; slot index 0 is reserved for null. Slots live in
+// chunks which never move, so references stay valid while the arena grows.
+// Freed slots are kept in an intrusive free list, and the chunks are released
+// as soon as no slot is in use anymore.
+// The tables of chunks of all the arenas of `T` are kept in one array indexed
+// by the arena id, so a reference is resolved with two loads. Arena 0 is
+// shared by the whole process and takes a lock to allocate and deallocate;
+// the others belong to one allocator and its copies, and are not
+// synchronized. Addresses are looked up without a lock: a grown table of
+// chunks does not replace the old one until the chunks are released.
+template <typename T> class arena
+{
+public:
+  using reference_type = std::uint32_t;
+
+  static constexpr std::size_t id_bits = 6;
+  static constexpr std::size_t index_bits =
+    std::numeric_limits<reference_type>::digits - id_bits;
+  static constexpr std::size_t arena_count = std::size_t(1) << id_bits;
+
+  static constexpr std::size_t chunk_bits = 12;
+  static constexpr std::size_t chunk_slots = std::size_t(1) << chunk_bits;
+
+public:
+  constexpr explicit arena(reference_type id) noexcept
+  : id_(id)
+  , chunk_count_(0)
+  , chunk_capacity_(0)
+  , next_(1)
+  , free_(0)
+  , slots_in_use_(0)
+  , mutex_()
+  {
+  }
+
+  arena(const arena&) = delete;
+  arena& operator=(const arena&) = delete;
+
+  ~arena()
+  {
+    release_chunks_();
+  }
+
+  // The arena shared by the whole process
+  static arena& shared() noexcept
+  {
+    return shared_;
+  }
+
+  // Creates an arena of its own, or returns `nullptr` if all the ids are
+  // taken
+  static arena* create()
+  {
+    std::lock_guard<std::mutex> lock(ids_mutex_);
+
+    for (reference_type id = 1; id < arena_count; ++id)
+    {
+      if (owners_[id] == nullptr)
+      {
+        owners_[id] = new arena(id);
+
+        return owners_[id];
+      }
+    }
+
+    return nullptr;
+  }
+
+  // Destroys an arena made by `create`
+  static void destroy(arena* p_arena) noexcept
+  {
+    assert(p_arena != nullptr && p_arena->id_ != 0);
+
+    const reference_type id = p_arena->id_;
+
+    delete p_arena;
+
+    std::lock_guard<std::mutex> lock(ids_mutex_);
+    owners_[id] = nullptr;
+  }
+
+  // The arena which the reference `r` points into
+  static arena& owner(reference_type r) noexcept
+  {
+    assert(owners_[r >> index_bits] != nullptr);
+
+    return *owners_[r >> index_bits];
+  }
+
+  static constexpr std::size_t max_size() noexcept
+  {
+    return (std::size_t(1) << index_bits) - 1 - chunk_slots;
+  }
+
+  static T* address(reference_type r) noexcept
+  {
+    assert((r & index_mask_) != 0);
+
+    const reference_type i = r & index_mask_;
+
+    slot* const* const p_chunks =
+      tables_[r >> index_bits].load(std::memory_order_acquire);
+
+    return reinterpret_cast<T*>(p_chunks[i >> chunk_bits] +
+                                (i & (chunk_slots - 1)));
+  }
+
+  // Single slots are taken from the free list first; runs of slots are cut
+  // from the end of the used range and never cross a chunk boundary.
+  reference_type allocate(std::size_t n)
+  {
+    if (n == 0 || n > chunk_slots)
+      throw std::bad_alloc();
+
+    const auto lock = lock_();
+
+    if (n == 1 && free_ != 0)
+    {
+      const reference_type i = free_;
+      free_ = *next_free_(i);
+
+      ++slots_in_use_;
+
+      return reference_(i);
+    }
+
+    if ((next_ & (chunk_slots - 1)) + n > chunk_slots)
+      next_ = (next_ | (chunk_slots - 1)) + 1;
+
+    if (max_size() < next_)
+      throw std::bad_alloc();
+
+    if (next_ / chunk_slots == chunk_count_)
+      add_chunk_();
+
+    const reference_type i = next_;
+    next_ += static_cast<reference_type>(n);
+
+    slots_in_use_ += n;
+
+    return reference_(i);
+  }
+
+  void deallocate(reference_type r, std::size_t n) noexcept
+  {
+    assert((r >> index_bits) == id_);
+
+    const auto lock = lock_();
+
+    assert(slots_in_use_ >= n);
+
+    const reference_type i = r & index_mask_;
+
+    for (std::size_t k = 0; k < n; ++k)
+    {
+      const reference_type slot = static_cast<reference_type>(i + k);
+
+      T* const p_slot = address(reference_(slot));
+
+      ::new (static_cast<void*>(p_slot)) reference_type(free_);
+      free_ = slot;
+    }
+
+    if ((slots_in_use_ -= n) == 0)
+      release_chunks_();
+  }
+
+private:
+  using slot =
+    typename std::aligned_storage<(sizeof(T) < sizeof(reference_type)
+                                     ? sizeof(reference_type)
+                                     : sizeof(T)),
+                                  (alignof(T) < alignof(reference_type)
+                                     ? alignof(reference_type)
+                                     : alignof(T))>::type;
+
+  static constexpr reference_type index_mask_ =
+    (reference_type(1) << index_bits) - 1;
+
+  // Only the shared arena is locked
+  std::unique_lock<std::mutex> lock_()
+  {
+    return id_ == 0 ? std::unique_lock<std::mutex>(mutex_)
+                    : std::unique_lock<std::mutex>();
+  }
+
+  reference_type reference_(reference_type i) const noexcept
+  {
+    return (id_ << index_bits) | i;
+  }
+
+  // The link of the free slot `i` to the next free slot
+  reference_type* next_free_(reference_type i) const noexcept
+  {
+    return std::launder(reinterpret_cast<reference_type*>(
+      static_cast<void*>(address(reference_(i)))));
+  }
+
+  // Tables of chunks have one more entry, past the capacity, which links to
+  // the smaller table that they replaced
+  void add_chunk_()
+  {
+    slot** p_chunks = tables_[id_].load(std::memory_order_relaxed);
+
+    if (chunk_count_ == chunk_capacity_)
+    {
+      const std::size_t capacity =
+        chunk_capacity_ == 0 ? 8 : 2 * chunk_capacity_;
+
+      slot** const p_grown = std::allocator<slot*>().allocate(capacity + 1);
+
+      if (chunk_count_ != 0)
+        std::memcpy(p_grown, p_chunks, chunk_count_ * sizeof(slot*));
+
+      p_grown[capacity] = reinterpret_cast<slot*>(p_chunks);
+
+      p_chunks = p_grown;
+      chunk_capacity_ = capacity;
+    }
+
+    p_chunks[chunk_count_] = std::allocator<slot>().allocate(chunk_slots);
+    ++chunk_count_;
+
+    tables_[id_].store(p_chunks, std::memory_order_release);
+  }
+
+  void release_chunks_() noexcept
+  {
+    slot** p_chunks = tables_[id_].load(std::memory_order_relaxed);
+
+    for (std::size_t k = 0; k < chunk_count_; ++k)
+    {
+      std::allocator<slot>().deallocate(p_chunks[k], chunk_slots);
+    }
+
+    for (auto capacity = chunk_capacity_; p_chunks != nullptr; capacity /= 2)
+    {
+      slot** const p_replaced = reinterpret_cast<slot**>(p_chunks[capacity]);
+
+      std::allocator<slot*>().deallocate(p_chunks, capacity + 1);
+      p_chunks = p_replaced;
+    }
+
+    tables_[id_].store(nullptr, std::memory_order_relaxed);
+    chunk_count_ = 0;
+    chunk_capacity_ = 0;
+    next_ = 1;
+    free_ = 0;
+  }
+
+private:
+  static arena shared_;
+  static std::atomic<slot**> tables_[arena_count];
+  static arena* owners_[arena_count];
+  static std::mutex ids_mutex_;
+
+  const reference_type id_;
+  std::size_t chunk_count_;
+  std::size_t chunk_capacity_;
+  reference_type next_;
+  reference_type free_;
+  std::size_t slots_in_use_;
+  std::mutex mutex_;
+};
+
+template <typename T> arena<T> arena<T>::shared_(0);
+
+template <typename T>
+std::atomic<typename arena<T>::slot**>
+  arena<T>::tables_[arena<T>::arena_count];
+
+template <typename T>
+arena<T>* arena<T>::owners_[arena<T>::arena_count] = {&arena<T>::shared_};
+
+template <typename T> std::mutex arena<T>::ids_mutex_;
+
+// Arenas shared by all the copies and rebinds of one arena allocator, one
+// arena per element type. They are created on the first allocation, so
+// rebinds that never allocate, like the element allocator of a node-based
+// container, take no arena id.
+class arena_set
+{
+public:
+  arena_set() = default;
+
+  arena_set(const arena_set&) = delete;
+  arena_set& operator=(const arena_set&) = delete;
+
+  ~arena_set()
+  {
+    for (const auto& a : arenas_)
+    {
+      if (a.destroy != nullptr)
+        a.destroy(a.p_arena);
+    }
+  }
+
+  template <typename T> arena<T>& get()
+  {
+    const void* const key = &arena<T>::shared();
+
+    for (const auto& a : arenas_)
+    {
+      if (a.key == key)
+        return *static_cast<arena<T>*>(a.p_arena);
+    }
+
+    arena<T>* const p_arena = arena<T>::create();
+
+    // Falls back to the shared arena once all the ids are taken
+    if (p_arena == nullptr)
+    {
+      arenas_.push_front(entry{key, &arena<T>::shared(), nullptr});
+
+      return arena<T>::shared();
+    }
+
+    try
+    {
+      arenas_.push_front(entry{key, p_arena, &destroy_<T>});
+    }
+    catch (...)
+    {
+      arena<T>::destroy(p_arena);
+
+      throw;
+    }
+
+    return *p_arena;
+  }
+
+private:
+  struct entry
+  {
+    const void* key;
+    void* p_arena;
+    void (*destroy)(void*);
+  };
+
+  template <typename T> static void destroy_(void* p_arena) noexcept
+  {
+    arena<T>::destroy(static_cast<arena<T>*>(p_arena));
+  }
+
+  std::forward_list<entry> arenas_;
+};
+}
+}
+
+/// @class arena_ptr dst/allocator/arena_allocator.h
+/// Pointer to an object allocated by an arena_allocator. It is stored as
+/// a 32-bit reference to a slot of an arena of its element type, so that
+/// node-based containers spend four bytes per link instead of eight.
+template <typename T> class arena_ptr
+{
+private:
+  using arena_type =
+    detail::allocator::arena<typename std::remove_const<T>::type>;
+
+public:
+  using element_type = T;
+  using difference_type = std::ptrdiff_t;
+  using index_type = std::uint32_t;
+
+  template <typename U> using rebind = arena_ptr<U>;
+
+public:
+  arena_ptr() noexcept
+  : index_(0)
+  {
+  }
+
+  arena_ptr(std::nullptr_t) noexcept
+  : index_(0)
+  {
+  }
+
+  template <typename U,
+            typename = typename std::enable_if<
+              std::is_convertible<U*, T*>::value>::type>
+  arena_ptr(const arena_ptr<U>& other) noexcept
+  : index_(other.index())
+  {
+  }
+
+  static arena_ptr from_index(index_type index) noexcept
+  {
+    arena_ptr p;
+    p.index_ = index;
+
+    return p;
+  }
+
+  index_type index() const noexcept
+  {
+    return index_;
+  }
+
+  T* get() const noexcept
+  {
+    return index_ == 0 ? nullptr : arena_type::address(index_);
+  }
+
+  typename std::add_lvalue_reference<T>::type operator*() const noexcept
+  {
+    return *arena_type::address(index_);
+  }
+
+  T* operator->() const noexcept
+  {
+    return arena_type::address(index_);
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return index_ != 0;
+  }
+
+  friend bool operator==(const arena_ptr& lhs, const arena_ptr& rhs) noexcept
+  {
+    return lhs.index_ == rhs.index_;
+  }
+
+  friend bool operator!=(const arena_ptr& lhs, const arena_ptr& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+  friend bool operator==(const arena_ptr& lhs, std::nullptr_t) noexcept
+  {
+    return lhs.index_ == 0;
+  }
+
+  friend bool operator!=(const arena_ptr& lhs, std::nullptr_t) noexcept
+  {
+    return lhs.index_ != 0;
+  }
+
+private:
+  index_type index_;
+};
+
+/// @class arena_allocator dst/allocator/arena_allocator.h
+/// Allocator which places objects into arenas of contiguous chunks and hands
+/// out 32-bit arena_ptr's to them. Together with the 32-bit `size_type` it
+/// makes the links and ranks of tree nodes half as wide, and dense chunks
+/// without per-allocation headers keep the nodes of a container close to
+/// each other.
+/// A default-constructed allocator gets an arena per element type of its
+/// own, which its copies and rebinds share, so unrelated containers neither
+/// contend for a lock nor keep each other's memory. An arena holds about 2^26
+/// objects at most. There are 63 such arenas per element type; once they are
+/// all taken, further allocators share one locked arena per element type.
+/// Copies of an arena allocator share the arenas, which are not
+/// synchronized.
+template <typename T> class arena_allocator
+{
+private:
+  using arena_type = detail::allocator::arena<T>;
+
+public:
+  using value_type = T;
+  using pointer = arena_ptr<T>;
+  using const_pointer = arena_ptr<const T>;
+  using size_type = std::uint32_t;
+  using difference_type = std::int32_t;
+
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template <typename U> struct rebind
+  {
+    using other = arena_allocator<U>;
+  };
+
+public:
+  arena_allocator()
+  : p_arenas_(std::make_shared<detail::allocator::arena_set>())
+  , p_arena_(nullptr)
+  {
+  }
+
+  // Declared, so that moves copy too and leave the source usable
+  arena_allocator(const arena_allocator& other) = default;
+
+  template <class U>
+  arena_allocator(const arena_allocator<U>& other) noexcept
+  : p_arenas_(other.p_arenas_)
+  , p_arena_(nullptr)
+  {
+  }
+
+  pointer allocate(size_type n)
+  {
+    if (p_arena_ == nullptr)
+      p_arena_ = &p_arenas_->template get<T>();
+
+    return pointer::from_index(p_arena_->allocate(n));
+  }
+
+  void deallocate(pointer p, size_type n) noexcept
+  {
+    arena_type::owner(p.index()).deallocate(p.index(), n);
+  }
+
+  size_type max_size() const noexcept
+  {
+    return static_cast<size_type>(arena_type::max_size());
+  }
+
+  template <typename U, typename V>
+  friend bool operator==(const arena_allocator<U>& lhs,
+                         const arena_allocator<V>& rhs) noexcept;
+
+private:
+  std::shared_ptr<detail::allocator::arena_set> p_arenas_;
+  arena_type* p_arena_;
+
+private:
+  template <typename> friend class arena_allocator;
+};
+
+template <typename T, typename U>
+bool operator==(const arena_allocator<T>& lhs,
+                const arena_allocator<U>& rhs) noexcept
+{
+  return lhs.p_arenas_ == rhs.p_arenas_;
+}
+
+template <typename T, typename U>
+bool operator!=(const arena_allocator<T>& lhs,
+                const arena_allocator<U>& rhs) noexcept
+{
+  return !(lhs == rhs);
+}
+
+} // dst
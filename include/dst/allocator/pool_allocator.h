@@ -0,0 +1,457 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include "utility.h"
+
+#include <algorithm>    // std::max, std::sort, std::upper_bound
+#include <cassert>      // assert
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint8_t
+#include <forward_list> // std::forward_list
+#include <functional>   // std::less
+#include <memory> // std::shared_ptr, std::make_shared, std::allocator_traits
+#include <new>    // std::bad_alloc
+#include <type_traits> // std::true_type, std::is_same
+#include <vector>
+
+namespace dst
+{
+
+namespace detail
+{
+
+namespace allocator
+{
+
+// A pool of equally sized memory blocks. Blocks are carved out of slabs
+// requested from the upstream allocator, freed blocks are kept in an intrusive
+// free list. All the slabs are returned upstream when no block is in use;
+// `release_free_slabs` returns the ones without blocks in use earlier.
+template <typename ByteAllocator> class pool
+{
+public:
+  pool(const ByteAllocator& allocator,
+       std::size_t block_size,
+       std::size_t block_alignment,
+       std::size_t blocks_per_slab)
+  : allocator_(allocator)
+  , block_size_(effective_size(block_size, block_alignment))
+  , block_alignment_(effective_alignment(block_alignment))
+  , blocks_per_slab_(blocks_per_slab)
+  , p_free_(nullptr)
+  , p_slabs_(nullptr)
+  , slab_count_(0)
+  , blocks_in_use_(0)
+  {
+    assert(blocks_per_slab_ > 0);
+  }
+
+  pool(const pool&) = delete;
+  pool& operator=(const pool&) = delete;
+
+  ~pool()
+  {
+    release_slabs_();
+  }
+
+  static std::size_t effective_alignment(std::size_t block_alignment)
+  {
+    return std::max(block_alignment, alignof(free_block));
+  }
+
+  static std::size_t effective_size(std::size_t block_size,
+                                    std::size_t block_alignment)
+  {
+    return round_up_(std::max(block_size, sizeof(free_block)),
+                     effective_alignment(block_alignment));
+  }
+
+  std::size_t block_size() const
+  {
+    return block_size_;
+  }
+
+  std::size_t block_alignment() const
+  {
+    return block_alignment_;
+  }
+
+  void* allocate()
+  {
+    if (p_free_ == nullptr)
+      add_slab_();
+
+    free_block* const p_block = p_free_;
+    p_free_ = p_block->p_next;
+
+    ++blocks_in_use_;
+
+    return p_block;
+  }
+
+  void deallocate(void* p)
+  {
+    assert(blocks_in_use_ > 0);
+
+    free_block* const p_block = static_cast<free_block*>(p);
+    p_block->p_next = p_free_;
+    p_free_ = p_block;
+
+    if (--blocks_in_use_ == 0)
+      release_slabs_();
+  }
+
+  // Returns upstream the slabs none of whose blocks is in use, in
+  // O(blocks * log(slabs)) time, so it is meant for rare calls, e.g. when a
+  // container that keeps a sentinel block is cleared
+  void release_free_slabs()
+  {
+    if (p_free_ != nullptr)
+      release_free_slabs_();
+  }
+
+private:
+  struct free_block
+  {
+    free_block* p_next;
+  };
+
+  struct slab
+  {
+    slab* p_next;
+  };
+
+  static std::size_t round_up_(std::size_t size, std::size_t alignment)
+  {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+  std::size_t slab_header_size_() const
+  {
+    return round_up_(sizeof(slab), block_alignment_);
+  }
+
+  std::size_t slab_alignment_() const
+  {
+    return std::max(block_alignment_, alignof(slab));
+  }
+
+  std::size_t slab_size_() const
+  {
+    return slab_header_size_() + block_size_ * blocks_per_slab_;
+  }
+
+  void add_slab_()
+  {
+    slab* const p_slab = static_cast<slab*>(
+      memory::allocate_aligned(allocator_, slab_size_(), slab_alignment_()));
+
+    p_slab->p_next = p_slabs_;
+    p_slabs_ = p_slab;
+    ++slab_count_;
+
+    std::uint8_t* const p_blocks =
+      reinterpret_cast<std::uint8_t*>(p_slab) + slab_header_size_();
+
+    for (std::size_t i = blocks_per_slab_; i != 0; --i)
+    {
+      free_block* const p_block =
+        reinterpret_cast<free_block*>(p_blocks + (i - 1) * block_size_);
+
+      p_block->p_next = p_free_;
+      p_free_ = p_block;
+    }
+  }
+
+  void release_slabs_()
+  {
+    while (p_slabs_ != nullptr)
+    {
+      slab* const p_next = p_slabs_->p_next;
+
+      memory::deallocate_aligned(
+        allocator_, p_slabs_, slab_size_(), slab_alignment_());
+
+      p_slabs_ = p_next;
+    }
+
+    p_free_ = nullptr;
+    slab_count_ = 0;
+  }
+
+  void release_free_slabs_()
+  {
+    using slab_allocator_type = typename std::allocator_traits<
+      ByteAllocator>::template rebind_alloc<slab*>;
+    using count_allocator_type = typename std::allocator_traits<
+      ByteAllocator>::template rebind_alloc<std::size_t>;
+
+    std::vector<slab*, slab_allocator_type> slabs(
+      slab_allocator_type{allocator_});
+
+    // Free blocks per slab
+    std::vector<std::size_t, count_allocator_type> free_blocks(
+      count_allocator_type{allocator_});
+
+    try
+    {
+      slabs.reserve(slab_count_);
+      free_blocks.resize(slab_count_, 0);
+    }
+    catch (const std::bad_alloc&)
+    {
+      // Keep the slabs until the pool is empty
+      return;
+    }
+
+    for (slab* p_slab = p_slabs_; p_slab != nullptr; p_slab = p_slab->p_next)
+      slabs.push_back(p_slab);
+
+    std::sort(slabs.begin(), slabs.end(), std::less<slab*>());
+
+    for (free_block* p_block = p_free_; p_block != nullptr;
+         p_block = p_block->p_next)
+    {
+      ++free_blocks[slab_index_(slabs, p_block)];
+    }
+
+    free_block** pp_free = &p_free_;
+
+    while (*pp_free != nullptr)
+    {
+      if (free_blocks[slab_index_(slabs, *pp_free)] == blocks_per_slab_)
+        *pp_free = (*pp_free)->p_next;
+      else
+        pp_free = &(*pp_free)->p_next;
+    }
+
+    p_slabs_ = nullptr;
+
+    for (std::size_t i = slabs.size(); i != 0; --i)
+    {
+      slab* const p_slab = slabs[i - 1];
+
+      if (free_blocks[i - 1] == blocks_per_slab_)
+      {
+        memory::deallocate_aligned(
+          allocator_, p_slab, slab_size_(), slab_alignment_());
+        --slab_count_;
+      }
+      else
+      {
+        p_slab->p_next = p_slabs_;
+        p_slabs_ = p_slab;
+      }
+    }
+  }
+
+  // Index of the slab holding `p_block` among `slabs` sorted by address
+  template <typename Slabs>
+  static std::size_t slab_index_(const Slabs& slabs, free_block* p_block)
+  {
+    slab* const p = reinterpret_cast<slab*>(p_block);
+
+    const auto it =
+      std::upper_bound(slabs.begin(), slabs.end(), p, std::less<slab*>());
+
+    assert(it != slabs.begin());
+
+    return static_cast<std::size_t>(it - slabs.begin()) - 1;
+  }
+
+private:
+  ByteAllocator allocator_;
+  const std::size_t block_size_;
+  const std::size_t block_alignment_;
+  const std::size_t blocks_per_slab_;
+  free_block* p_free_;
+  slab* p_slabs_;
+  std::size_t slab_count_;
+  std::size_t blocks_in_use_;
+};
+
+// Pools shared by all the copies and rebinds of one pool allocator, one pool
+// per block layout. Node-based containers usually rebind their allocator to
+// one or two node types, so the list stays short.
+template <typename ByteAllocator> class pool_set
+{
+public:
+  using pool_type = pool<ByteAllocator>;
+
+public:
+  pool_set(const ByteAllocator& allocator, std::size_t blocks_per_slab)
+  : allocator_(allocator)
+  , blocks_per_slab_(blocks_per_slab)
+  {
+  }
+
+  pool_type& get(std::size_t block_size, std::size_t block_alignment)
+  {
+    const std::size_t size =
+      pool_type::effective_size(block_size, block_alignment);
+    const std::size_t alignment =
+      pool_type::effective_alignment(block_alignment);
+
+    for (auto& p : pools_)
+    {
+      if (p.block_size() == size && p.block_alignment() == alignment)
+        return p;
+    }
+
+    pools_.emplace_front(
+      allocator_, block_size, block_alignment, blocks_per_slab_);
+
+    return pools_.front();
+  }
+
+private:
+  ByteAllocator allocator_;
+  const std::size_t blocks_per_slab_;
+  std::forward_list<pool_type> pools_;
+};
+}
+}
+
+/// @class pool_allocator dst/allocator/pool_allocator.h
+/// Allocator which serves single-object allocations from fixed-size slabs.
+/// Every rebind of the allocator (e.g. to the node type of a container) gets
+/// a pool of blocks of exactly the rebound type's size. Deallocated objects go
+/// back to the pool's free list, so a node-based container does not call the
+/// upstream allocator per element. A pool returns its slabs upstream when no
+/// block is in use, and the ones without blocks in use on
+/// `release_free_slabs`, which the trees of this library call when cleared.
+/// Allocations of more than one object are forwarded to the upstream
+/// allocator.
+/// Copies of a pool allocator share the pools, which are not synchronized.
+template <typename T,
+          typename Allocator = std::allocator<T>,
+          std::size_t BlocksPerSlab = 256>
+class pool_allocator : private Allocator
+{
+private:
+  static_assert(
+    std::is_same<typename std::allocator_traits<Allocator>::pointer,
+                 T*>::value,
+    "Upstream allocator must use raw pointers");
+
+  using byte_allocator_type = typename std::allocator_traits<
+    Allocator>::template rebind_alloc<std::uint8_t>;
+
+  using pool_set_type = detail::allocator::pool_set<byte_allocator_type>;
+
+public:
+  using base_allocator_type = Allocator;
+
+  using value_type = T;
+  using pointer = T*;
+  using size_type = typename std::allocator_traits<Allocator>::size_type;
+
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template <typename U> struct rebind
+  {
+    using other = pool_allocator<
+      U,
+      typename std::allocator_traits<Allocator>::template rebind_alloc<U>,
+      BlocksPerSlab>;
+  };
+
+public:
+  pool_allocator(const Allocator& allocator = Allocator())
+  : Allocator(allocator)
+  , p_pools_(std::make_shared<pool_set_type>(byte_allocator_type(allocator),
+                                             BlocksPerSlab))
+  , p_pool_(&p_pools_->get(sizeof(T), alignof(T)))
+  {
+  }
+
+  // Declared, so that moves copy too: a moved-from allocator still shares the
+  // pools, which `p_pool_` points into
+  pool_allocator(const pool_allocator& other) = default;
+
+  template <class U, class A>
+  pool_allocator(const pool_allocator<U, A, BlocksPerSlab>& other)
+  : Allocator(other.base())
+  , p_pools_(other.p_pools_)
+  , p_pool_(&p_pools_->get(sizeof(T), alignof(T)))
+  {
+  }
+
+  pointer allocate(size_type n)
+  {
+    if (n == 1)
+      return static_cast<pointer>(p_pool_->allocate());
+
+    return base_().allocate(n);
+  }
+
+  void deallocate(pointer p, size_type n)
+  {
+    if (n == 1)
+      p_pool_->deallocate(p);
+    else
+      base_().deallocate(p, n);
+  }
+
+  // Returns upstream the slabs of the pool of `T` without blocks in use
+  void release_free_slabs()
+  {
+    p_pool_->release_free_slabs();
+  }
+
+  template <typename... Args> void construct(pointer p, Args&&... args)
+  {
+    std::allocator_traits<base_allocator_type>::construct(
+      *this, p, std::forward<Args>(args)...);
+  }
+
+  void destroy(pointer p)
+  {
+    std::allocator_traits<base_allocator_type>::destroy(*this, p);
+  }
+
+  template <typename U, typename A, typename V, typename B, std::size_t N>
+  friend bool operator==(const pool_allocator<U, A, N>& lhs,
+                         const pool_allocator<V, B, N>& rhs);
+
+public:
+  const base_allocator_type& base() const
+  {
+    return *this;
+  }
+
+private:
+  base_allocator_type& base_()
+  {
+    return *this;
+  }
+
+private:
+  std::shared_ptr<pool_set_type> p_pools_;
+  typename pool_set_type::pool_type* p_pool_;
+
+private:
+  template <typename, typename, std::size_t> friend class pool_allocator;
+};
+
+template <typename U, typename A, typename V, typename B, std::size_t N>
+bool operator==(const pool_allocator<U, A, N>& lhs,
+                const pool_allocator<V, B, N>& rhs)
+{
+  return lhs.base() == rhs.base() && lhs.p_pools_ == rhs.p_pools_;
+}
+
+template <typename U, typename A, typename V, typename B, std::size_t N>
+bool operator!=(const pool_allocator<U, A, N>& lhs,
+                const pool_allocator<V, B, N>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+} // dst
@@ -7,10 +7,11 @@
 #pragma once
 
 #include <cassert>
-#include <cstddef> // std::size_t, std::uint8_t
-#include <limits>  // std::numeric_limits
-#include <memory>  // std::allocator_traits, std::addressof
-#include <utility> // std::forward
+#include <cstddef>     // std::size_t, std::uint8_t
+#include <limits>      // std::numeric_limits
+#include <memory>      // std::allocator, std::allocator_traits, std::addressof
+#include <type_traits> // std::true_type, std::false_type
+#include <utility>     // std::forward
 
 namespace dst
 {
@@ -172,6 +173,20 @@ void delete_object(
 }
 } // memory
 
+/// Tells whether copies of an allocator may allocate and deallocate from
+/// several threads at once. Containers use it to decide whether they may hand
+/// their nodes to other threads. Unknown allocators are assumed not to be;
+/// specialize the trait for the ones that are.
+template <typename Allocator>
+struct is_thread_safe_allocator : std::false_type
+{
+};
+
+template <typename T>
+struct is_thread_safe_allocator<std::allocator<T>> : std::true_type
+{
+};
+
 /// A function for static downcasting of pointers. Should be used to cast
 /// base class pointers to most-derived class pointers.
 /// For raw pointers it performs simple @c static_cast. Custom pointer types
@@ -9,9 +9,9 @@
 #include "iterator_facade.h"
 
 #include <cassert>     // assert
+#include <cstddef>     // std::size_t
 #include <iterator>    // std::iterator_traits, std::iterator
 #include <type_traits> // std::is_convertible, std::enable_if
-#include <vector>
 
 namespace dst
 {
@@ -194,6 +194,24 @@ BinaryTreeIterator predecessor(BinaryTreeIterator position)
   return p;
 }
 
+template <typename BinaryTreeIterator,
+          typename = enable_for_binary_tree_iterator<BinaryTreeIterator>>
+std::size_t depth(BinaryTreeIterator position)
+{
+  assert(!!position);
+
+  std::size_t d = 0;
+
+  for (++position; !!position; ++position)
+  {
+    ++d;
+  }
+
+  return d;
+}
+
+// Tells whether `x` comes before `y` in order. Climbs from both nodes to
+// their lowest common ancestor, without allocating.
 template <typename BinaryTreeIterator,
           typename = enable_for_binary_tree_iterator<BinaryTreeIterator>>
 bool order(BinaryTreeIterator x, BinaryTreeIterator y)
@@ -207,40 +225,41 @@ bool order(BinaryTreeIterator x, BinaryTreeIterator y)
   if (!x)
     return false;
 
-  std::vector<BinaryTreeIterator> x_to_root_path;
-  std::vector<BinaryTreeIterator> y_to_root_path;
+  auto x_depth = depth(x);
+  auto y_depth = depth(y);
 
-  for (; !!x; ++x)
+  for (; x_depth > y_depth; --x_depth)
   {
-    x_to_root_path.push_back(x);
-  }
+    const auto p = parent(x);
 
-  for (; !!y; ++y)
-  {
-    y_to_root_path.push_back(y);
+    if (p == y)
+      return left(p) == x;
+
+    x = p;
   }
 
-  assert(x_to_root_path.back() == y_to_root_path.back());
+  for (; y_depth > x_depth; --y_depth)
+  {
+    const auto p = parent(y);
 
-  auto it_x = x_to_root_path.crbegin(), it_y = y_to_root_path.crbegin();
+    if (p == x)
+      return right(p) == y;
 
-  for (; it_x != x_to_root_path.crend() && it_y != y_to_root_path.crend();
-       ++it_x, ++it_y)
-  {
-    if (*it_x != *it_y)
-      return (left(parent(*it_x)) == *it_x);
+    y = p;
   }
 
-  if (it_x != x_to_root_path.crend())
-    return (left(parent(*it_x)) == *it_x);
+  assert(x != y);
 
-  if (it_y != y_to_root_path.crend())
-    return (right(parent(*it_y)) == *it_y);
+  while (parent(x) != parent(y))
+  {
+    x = parent(x);
+    y = parent(y);
+  }
 
-  assert(false);
+  assert(!!parent(x));
 
-  return false;
-};
+  return left(parent(x)) == x;
+}
 
 template <typename BinaryTreeIterator>
 class inorder_depth_first_search_iterator
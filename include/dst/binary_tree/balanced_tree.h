@@ -53,9 +53,11 @@ public:
   using base::end;
   using base::erase;
   using base::get_allocator;
+  using base::get_parallel_policy;
   using base::max_size;
   using base::nil;
   using base::root;
+  using base::set_parallel_policy;
   using base::size;
   using base::swap;
 
@@ -0,0 +1,787 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include "list.h"
+#include "mixin/aggregating.h"
+#include "mixin/indexing.h"
+
+#include <dst/iterator_facade.h>
+
+#include <algorithm>        // std::equal, std::move, std::rotate
+#include <cassert>          // assert
+#include <cstddef>          // std::size_t
+#include <initializer_list> // std::initializer_list
+#include <iterator>         // std::next, std::prev
+#include <memory>           // std::allocator, std::allocator_traits
+#include <new>              // placement new
+#include <type_traits>      // std::aligned_storage
+#include <utility>          // std::forward, std::move
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+namespace detail
+{
+
+// Up to `Capacity` elements stored contiguously
+template <typename T, std::size_t Capacity> class block
+{
+public:
+  using size_type = std::size_t;
+
+public:
+  block()
+  : size_(0)
+  {
+  }
+
+  block(const block& other)
+  : size_(0)
+  {
+    try
+    {
+      for (; size_ < other.size_; ++size_)
+      {
+        new (&data_[size_]) T(other[size_]);
+      }
+    }
+    catch (...)
+    {
+      erase(0, size_);
+      throw;
+    }
+  }
+
+  block(block&& other)
+  : size_(0)
+  {
+    append_from(other, 0, other.size_);
+  }
+
+  block& operator=(const block&) = delete;
+  block& operator=(block&&) = delete;
+
+  ~block()
+  {
+    erase(0, size_);
+  }
+
+  size_type size() const
+  {
+    return size_;
+  }
+
+  bool empty() const
+  {
+    return size_ == 0;
+  }
+
+  bool full() const
+  {
+    return size_ == Capacity;
+  }
+
+  T* begin()
+  {
+    return reinterpret_cast<T*>(&data_[0]);
+  }
+
+  const T* begin() const
+  {
+    return reinterpret_cast<const T*>(&data_[0]);
+  }
+
+  T* end()
+  {
+    return begin() + size_;
+  }
+
+  const T* end() const
+  {
+    return begin() + size_;
+  }
+
+  T& operator[](size_type i)
+  {
+    assert(i < size_);
+
+    return begin()[i];
+  }
+
+  const T& operator[](size_type i) const
+  {
+    assert(i < size_);
+
+    return begin()[i];
+  }
+
+  template <typename... Args> void emplace(size_type i, Args&&... args)
+  {
+    assert(i <= size_ && size_ < Capacity);
+
+    if (i == size_)
+    {
+      new (&data_[size_]) T(std::forward<Args>(args)...);
+      ++size_;
+
+      return;
+    }
+
+    // `args` may refer to an element of this block
+    T v(std::forward<Args>(args)...);
+
+    new (&data_[size_]) T(std::move(begin()[size_ - 1]));
+    ++size_;
+
+    std::move_backward(begin() + i, end() - 2, end() - 1);
+    begin()[i] = std::move(v);
+  }
+
+  // Erases `n` elements starting from `i`.
+  void erase(size_type i, size_type n = 1)
+  {
+    assert(i + n <= size_);
+
+    std::move(begin() + i + n, end(), begin() + i);
+
+    for (; n > 0; --n)
+    {
+      begin()[--size_].~T();
+    }
+  }
+
+  // Moves `n` elements of `from` starting from `i` to the end of this block.
+  void append_from(block& from, size_type i, size_type n)
+  {
+    assert(size_ + n <= Capacity);
+
+    for (size_type k = 0; k < n; ++k)
+    {
+      new (&data_[size_]) T(std::move(from[i + k]));
+      ++size_;
+    }
+
+    from.erase(i, n);
+  }
+
+private:
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type data_[Capacity];
+  size_type size_;
+};
+
+template <typename Block> class block_size_monoid
+{
+public:
+  using summary_type = typename Block::size_type;
+
+  static summary_type identity()
+  {
+    return 0;
+  }
+
+  static summary_type summarize(const Block& b)
+  {
+    return b.size();
+  }
+
+  static summary_type combine(summary_type lhs, summary_type rhs)
+  {
+    return lhs + rhs;
+  }
+};
+
+} // detail
+
+/// @class blocked_list dst/binary_tree/blocked_list.h
+/// Sequence container with the interface of `list` which stores its
+/// elements in blocks of up to `BlockSize` contiguous elements. The blocks
+/// are kept in a balanced tree which sums up the element counts of its
+/// subtrees, so indexing takes O(log(n / BlockSize)) time, while insertion
+/// and erasure additionally move up to `BlockSize` elements. Scans touch one
+/// tree node per block instead of one per element. Every block but the last
+/// one is at least a quarter full.
+/// Unlike `list`, insertion and erasure invalidate all the iterators.
+template <typename T,
+          typename Allocator = std::allocator<T>,
+          std::size_t BlockSize = 64>
+class blocked_list
+{
+private:
+  static_assert(BlockSize >= 4, "Blocks must hold at least 4 elements");
+
+  using block_type = detail::block<T, BlockSize>;
+
+  using block_list = list<
+    block_type,
+    typename std::allocator_traits<Allocator>::template rebind_alloc<
+      block_type>,
+    Indexing,
+    Aggregating<detail::block_size_monoid<block_type>>,
+    AVL>;
+
+  using block_iterator = typename block_list::iterator;
+  using const_block_iterator = typename block_list::const_iterator;
+
+  template <typename U, typename BlockIterator>
+  class iterator_base
+  : public iterator_facade<iterator_base<U, BlockIterator>,
+                           std::bidirectional_iterator_tag,
+                           U>
+  {
+  private:
+    friend iterator_facade<iterator_base<U, BlockIterator>,
+                           std::bidirectional_iterator_tag,
+                           U>;
+
+    friend blocked_list;
+
+  public:
+    iterator_base()
+    : block_()
+    , offset_(0)
+    {
+    }
+
+    template <
+      typename V,
+      typename OtherBlockIterator,
+      typename = typename std::enable_if<
+        std::is_convertible<OtherBlockIterator, BlockIterator>::value>::type>
+    iterator_base(const iterator_base<V, OtherBlockIterator>& other)
+    : block_(other.block_)
+    , offset_(other.offset_)
+    {
+    }
+
+    friend bool operator==(const iterator_base& lhs, const iterator_base& rhs)
+    {
+      return lhs.block_ == rhs.block_ && lhs.offset_ == rhs.offset_;
+    }
+
+  private:
+    template <typename, typename> friend class iterator_base;
+
+    iterator_base(BlockIterator block, std::size_t offset)
+    : block_(block)
+    , offset_(offset)
+    {
+    }
+
+    U& value() const
+    {
+      return (*block_)[offset_];
+    }
+
+    void move_forward()
+    {
+      if (++offset_ == block_->size())
+      {
+        ++block_;
+        offset_ = 0;
+      }
+    }
+
+    void move_back()
+    {
+      if (offset_ == 0)
+      {
+        --block_;
+        offset_ = block_->size();
+      }
+
+      --offset_;
+    }
+
+  private:
+    BlockIterator block_;
+    std::size_t offset_;
+  };
+
+public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using size_type = typename std::allocator_traits<Allocator>::size_type;
+  using difference_type =
+    typename std::allocator_traits<Allocator>::difference_type;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = typename std::allocator_traits<Allocator>::pointer;
+  using const_pointer =
+    typename std::allocator_traits<Allocator>::const_pointer;
+
+  using iterator = iterator_base<T, block_iterator>;
+  using const_iterator = iterator_base<const T, const_block_iterator>;
+
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  static constexpr std::size_t block_size = BlockSize;
+
+public:
+  blocked_list()
+  : blocks_()
+  {
+  }
+
+  explicit blocked_list(const allocator_type& allocator)
+  : blocks_(block_allocator_type(allocator))
+  {
+  }
+
+  blocked_list(const blocked_list& other) = default;
+  blocked_list(blocked_list&& other) = default;
+
+  blocked_list(const blocked_list& other, const allocator_type& allocator)
+  : blocks_(other.blocks_, block_allocator_type(allocator))
+  {
+  }
+
+  blocked_list(blocked_list&& other, const allocator_type& allocator)
+  : blocks_(std::move(other.blocks_), block_allocator_type(allocator))
+  {
+  }
+
+  template <typename InputIterator,
+            typename = enable_for_input_iterator<InputIterator>>
+  blocked_list(InputIterator from,
+               InputIterator to,
+               const allocator_type& allocator = allocator_type())
+  : blocked_list(allocator)
+  {
+    insert(cend(), from, to);
+  }
+
+  blocked_list(const std::initializer_list<value_type>& init,
+               const allocator_type& allocator = allocator_type())
+  : blocked_list(init.begin(), init.end(), allocator)
+  {
+  }
+
+  blocked_list& operator=(const blocked_list& other) = default;
+  blocked_list& operator=(blocked_list&& other) = default;
+
+  blocked_list& operator=(const std::initializer_list<value_type>& init)
+  {
+    *this = blocked_list(init, get_allocator());
+
+    return *this;
+  }
+
+  allocator_type get_allocator() const
+  {
+    return allocator_type(blocks_.get_allocator());
+  }
+
+  size_type size() const
+  {
+    return blocks_.subtree_summary(blocks_.root());
+  }
+
+  bool empty() const
+  {
+    return blocks_.empty();
+  }
+
+  iterator begin()
+  {
+    return iterator(blocks_.begin(), 0);
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(blocks_.begin(), 0);
+  }
+
+  iterator end()
+  {
+    return iterator(blocks_.end(), 0);
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(blocks_.end(), 0);
+  }
+
+  const_iterator cbegin() const
+  {
+    return begin();
+  }
+
+  const_iterator cend() const
+  {
+    return end();
+  }
+
+  reverse_iterator rbegin()
+  {
+    return reverse_iterator(end());
+  }
+
+  const_reverse_iterator rbegin() const
+  {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend()
+  {
+    return reverse_iterator(begin());
+  }
+
+  const_reverse_iterator rend() const
+  {
+    return const_reverse_iterator(begin());
+  }
+
+  reference front()
+  {
+    return *begin();
+  }
+
+  const_reference front() const
+  {
+    return *begin();
+  }
+
+  reference back()
+  {
+    return *(--end());
+  }
+
+  const_reference back() const
+  {
+    return *(--end());
+  }
+
+  const_iterator element_at(size_type index) const
+  {
+    assert(index < size());
+
+    const auto b = blocks_.element_at_weight(index);
+
+    return const_iterator(b, index - blocks_.prefix_query(b));
+  }
+
+  iterator element_at(size_type index)
+  {
+    assert(index < size());
+
+    const auto b = blocks_.element_at_weight(index);
+
+    return iterator(b, index - blocks_.prefix_query(b));
+  }
+
+  const_reference at(size_type index) const
+  {
+    return *element_at(index);
+  }
+
+  reference at(size_type index)
+  {
+    return *element_at(index);
+  }
+
+  const_reference operator[](size_type index) const
+  {
+    return at(index);
+  }
+
+  reference operator[](size_type index)
+  {
+    return at(index);
+  }
+
+  size_type index(const_iterator position) const
+  {
+    return blocks_.prefix_query(position.block_) + position.offset_;
+  }
+
+  template <typename... Args>
+  iterator emplace(const_iterator position, Args&&... args)
+  {
+    auto b = block_const_cast_(position.block_);
+    auto offset = position.offset_;
+
+    if (b == blocks_.end())
+    {
+      if (empty() || blocks_.back().full())
+      {
+        b = blocks_.emplace(b);
+      }
+      else
+      {
+        --b;
+        offset = b->size();
+      }
+    }
+    else if (b->full())
+    {
+      // `args` may refer to an element which the split moves out
+      T v(std::forward<Args>(args)...);
+
+      const auto half = BlockSize / 2;
+      const auto next = blocks_.emplace_after(b);
+
+      next->append_from(*b, half, BlockSize - half);
+
+      blocks_.update(b);
+      blocks_.update(next);
+
+      if (offset > half)
+      {
+        b = next;
+        offset -= half;
+      }
+
+      return emplace_(b, offset, std::move(v));
+    }
+
+    return emplace_(b, offset, std::forward<Args>(args)...);
+  }
+
+  iterator insert(const_iterator position, const_reference v)
+  {
+    return emplace(position, v);
+  }
+
+  iterator insert(const_iterator position, value_type&& v)
+  {
+    return emplace(position, std::move(v));
+  }
+
+  iterator insert(const_iterator position,
+                  const std::initializer_list<value_type>& init)
+  {
+    return insert(position, init.begin(), init.end());
+  }
+
+  template <typename InputIterator,
+            typename = enable_for_input_iterator<InputIterator>>
+  iterator insert(const_iterator position, InputIterator from, InputIterator to)
+  {
+    const auto i = index(position);
+
+    for (auto pos = position; from != to; ++from, ++pos)
+    {
+      pos = emplace(pos, *from);
+    }
+
+    return i == size() ? end() : element_at(i);
+  }
+
+  iterator erase(const_iterator position)
+  {
+    assert(position != cend());
+
+    const auto b = block_const_cast_(position.block_);
+
+    b->erase(position.offset_);
+
+    return after_erasure_(b, position.offset_);
+  }
+
+  // Trims the two boundary blocks and frees the whole blocks between them in
+  // one pass, so it moves O(BlockSize) elements whatever the range length.
+  iterator erase(const_iterator from, const_iterator to)
+  {
+    const auto first = block_const_cast_(from.block_);
+    const auto last = block_const_cast_(to.block_);
+
+    if (from == to)
+      return iterator(last, to.offset_);
+
+    if (first == last)
+    {
+      first->erase(from.offset_, to.offset_ - from.offset_);
+
+      return after_erasure_(first, from.offset_);
+    }
+
+    // Refilling `last` can move elements of `first` into it, so the result
+    // is found by index
+    const auto i = index(from);
+
+    first->erase(from.offset_, first->size() - from.offset_);
+    blocks_.update(first);
+
+    blocks_.erase(std::next(first), last);
+
+    if (last != blocks_.end())
+    {
+      last->erase(0, to.offset_);
+      after_erasure_(last, 0);
+    }
+
+    after_erasure_(first, from.offset_);
+
+    return i == size() ? end() : element_at(i);
+  }
+
+  template <typename... Args> reference emplace_back(Args&&... args)
+  {
+    return *emplace(cend(), std::forward<Args>(args)...);
+  }
+
+  void push_back(const_reference v)
+  {
+    emplace_back(v);
+  }
+
+  void push_back(value_type&& v)
+  {
+    emplace_back(std::move(v));
+  }
+
+  void pop_back()
+  {
+    erase(--cend());
+  }
+
+  template <typename... Args> reference emplace_front(Args&&... args)
+  {
+    return *emplace(cbegin(), std::forward<Args>(args)...);
+  }
+
+  void push_front(const_reference v)
+  {
+    emplace_front(v);
+  }
+
+  void push_front(value_type&& v)
+  {
+    emplace_front(std::move(v));
+  }
+
+  void pop_front()
+  {
+    erase(cbegin());
+  }
+
+  void clear()
+  {
+    blocks_.clear();
+  }
+
+  void swap(blocked_list& other)
+  {
+    blocks_.swap(other.blocks_);
+  }
+
+  friend void swap(blocked_list& lhs, blocked_list& rhs)
+  {
+    lhs.swap(rhs);
+  }
+
+  bool operator==(const blocked_list& other) const
+  {
+    return size() == other.size() &&
+           std::equal(cbegin(), cend(), other.cbegin());
+  }
+
+  bool operator!=(const blocked_list& other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  using block_allocator_type = typename block_list::allocator_type;
+
+private:
+  // `list` keeps its conversion of constant iterators protected; an empty
+  // erasure does the same in O(1) time
+  block_iterator block_const_cast_(const_block_iterator b)
+  {
+    return blocks_.erase(b, b);
+  }
+
+  // Constructs an element at `offset` of the block `b`, which is not full
+  template <typename... Args>
+  iterator emplace_(block_iterator b, size_type offset, Args&&... args)
+  {
+    try
+    {
+      b->emplace(offset, std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      if (b->empty())
+        blocks_.erase(b);
+
+      throw;
+    }
+
+    blocks_.update(b);
+
+    return iterator(b, offset);
+  }
+
+  // Restores the fill of the block `b` after erasing elements from it and
+  // returns the position of its element which was at `offset`
+  iterator after_erasure_(block_iterator b, size_type offset)
+  {
+    if (b->empty())
+      return iterator(blocks_.erase(b), 0);
+
+    if (b->size() < BlockSize / 4)
+    {
+      const auto next = std::next(b);
+
+      if (next != blocks_.end())
+      {
+        if (b->size() + next->size() <= BlockSize)
+        {
+          b->append_from(*next, 0, next->size());
+          blocks_.erase(next);
+        }
+        else
+        {
+          b->append_from(*next, 0, (next->size() - b->size()) / 2);
+          blocks_.update(next);
+        }
+      }
+      else if (b != blocks_.begin())
+      {
+        const auto prev = std::prev(b);
+
+        if (prev->size() + b->size() <= BlockSize)
+        {
+          offset += prev->size();
+          prev->append_from(*b, 0, b->size());
+          blocks_.erase(b);
+          b = prev;
+        }
+        else
+        {
+          const auto n = (prev->size() - b->size()) / 2;
+
+          b->append_from(*prev, prev->size() - n, n);
+          std::rotate(b->begin(), b->end() - n, b->end());
+          offset += n;
+
+          blocks_.update(prev);
+        }
+      }
+    }
+
+    blocks_.update(b);
+
+    if (offset == b->size())
+      return iterator(std::next(b), 0);
+
+    return iterator(b, offset);
+  }
+
+private:
+  block_list blocks_;
+};
+
+} // binary_tree
+
+} // dst
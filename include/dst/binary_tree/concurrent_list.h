@@ -0,0 +1,345 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/epoch.h>
+#include <dst/binary_tree/persistent_list.h>
+
+#include <atomic>  // std::atomic
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <memory>  // std::allocator_traits, std::pointer_traits
+#include <utility> // std::forward, std::move, std::pair
+#include <vector>
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+/// @class concurrent_list dst/binary_tree/concurrent_list.h
+/// Sequence of elements changed by one writer thread and read by any number
+/// of threads without locks. The writer changes its own `persistent_list`,
+/// which copies the O(log n) shared nodes on the path of each change, and
+/// publishes a snapshot of it by swapping an atomic pointer. A reader pins
+/// the current epoch and reads the snapshot published by then. Replaced
+/// snapshots, and with them the nodes that only they refer to, are freed
+/// once no reader that could see them is still pinned.
+/// The allocator must be safe to use from the writer thread while readers
+/// hold snapshots.
+template <typename T, typename Allocator = std::allocator<T>>
+class concurrent_list
+{
+public:
+  using list_type = persistent_list<T, Allocator>;
+
+  using value_type = T;
+  using allocator_type = Allocator;
+  using size_type = typename list_type::size_type;
+  using difference_type = typename list_type::difference_type;
+  using reference = typename list_type::reference;
+  using const_reference = typename list_type::const_reference;
+
+  using iterator = typename list_type::const_iterator;
+  using const_iterator = typename list_type::const_iterator;
+
+  // Read access to the snapshot published when the reader was created.
+  // Keeps its epoch pinned, so readers should not live long.
+  class reader
+  {
+  public:
+    size_type size() const
+    {
+      return p_list_->size();
+    }
+
+    bool empty() const
+    {
+      return p_list_->empty();
+    }
+
+    const_iterator begin() const
+    {
+      return p_list_->begin();
+    }
+
+    const_iterator end() const
+    {
+      return p_list_->end();
+    }
+
+    const_iterator cbegin() const
+    {
+      return p_list_->cbegin();
+    }
+
+    const_iterator cend() const
+    {
+      return p_list_->cend();
+    }
+
+    const_reference front() const
+    {
+      return p_list_->front();
+    }
+
+    const_reference back() const
+    {
+      return p_list_->back();
+    }
+
+    const_reference at(size_type index) const
+    {
+      return p_list_->at(index);
+    }
+
+    const_reference operator[](size_type index) const
+    {
+      return (*p_list_)[index];
+    }
+
+    // The snapshot itself; a copy of it stays valid after the reader is gone
+    const list_type& snapshot() const
+    {
+      return *p_list_;
+    }
+
+  private:
+    friend concurrent_list;
+
+    reader(epoch_domain::guard&& guard, const list_type* p_list)
+    : guard_(std::move(guard))
+    , p_list_(p_list)
+    {
+    }
+
+  private:
+    epoch_domain::guard guard_;
+    const list_type* p_list_;
+  };
+
+public:
+  concurrent_list()
+  : concurrent_list(allocator_type())
+  {
+  }
+
+  explicit concurrent_list(const allocator_type& allocator)
+  : list_(allocator)
+  , snapshot_allocator_(allocator)
+  , epoch_()
+  , p_published_(new_snapshot_())
+  , retired_()
+  {
+    retired_.reserve(reclaim_period);
+  }
+
+  concurrent_list(const concurrent_list&) = delete;
+  concurrent_list& operator=(const concurrent_list&) = delete;
+
+  // No reader may be alive
+  ~concurrent_list()
+  {
+    for (const auto& r : retired_)
+    {
+      delete_snapshot_(r.second);
+    }
+
+    delete_snapshot_(p_published_.load());
+  }
+
+  allocator_type get_allocator() const
+  {
+    return list_.get_allocator();
+  }
+
+  // May be called from any thread
+  reader read() const
+  {
+    auto guard = epoch_.pin();
+
+    return reader(std::move(guard), p_published_.load());
+  }
+
+  // The writer's own view of the list. The members below must be called by
+  // the writer thread only; each change is published before it returns.
+  const list_type& list() const
+  {
+    return list_;
+  }
+
+  size_type size() const
+  {
+    return list_.size();
+  }
+
+  bool empty() const
+  {
+    return list_.empty();
+  }
+
+  template <typename... Args> void emplace(size_type index, Args&&... args)
+  {
+    list_.emplace(index, std::forward<Args>(args)...);
+    publish_();
+  }
+
+  void insert(size_type index, const_reference v)
+  {
+    emplace(index, v);
+  }
+
+  void insert(size_type index, value_type&& v)
+  {
+    emplace(index, std::move(v));
+  }
+
+  void erase(size_type index)
+  {
+    list_.erase(index);
+    publish_();
+  }
+
+  void set(size_type index, value_type v)
+  {
+    list_.set(index, std::move(v));
+    publish_();
+  }
+
+  template <typename... Args> void emplace_back(Args&&... args)
+  {
+    emplace(size(), std::forward<Args>(args)...);
+  }
+
+  void push_back(const_reference v)
+  {
+    emplace_back(v);
+  }
+
+  void push_back(value_type&& v)
+  {
+    emplace_back(std::move(v));
+  }
+
+  void pop_back()
+  {
+    erase(size() - 1);
+  }
+
+  template <typename... Args> void emplace_front(Args&&... args)
+  {
+    emplace(0, std::forward<Args>(args)...);
+  }
+
+  void push_front(const_reference v)
+  {
+    emplace_front(v);
+  }
+
+  void push_front(value_type&& v)
+  {
+    emplace_front(std::move(v));
+  }
+
+  void pop_front()
+  {
+    erase(0);
+  }
+
+  void clear()
+  {
+    list_.clear();
+    publish_();
+  }
+
+  // Calls `f` with the writer's list and publishes the result once, so a
+  // batch of changes copies each shared node only once.
+  template <typename Function> void update(Function f)
+  {
+    f(list_);
+    publish_();
+  }
+
+  // Frees the replaced snapshots that no reader can see any more. Happens
+  // on its own every `reclaim_period` changes.
+  void reclaim()
+  {
+    const auto oldest = epoch_.oldest();
+
+    auto it = retired_.begin();
+
+    for (; it != retired_.end() && it->first < oldest; ++it)
+    {
+      delete_snapshot_(it->second);
+    }
+
+    retired_.erase(retired_.begin(), it);
+  }
+
+  static constexpr std::size_t reclaim_period = 64;
+
+private:
+  using snapshot_allocator_type =
+    typename std::allocator_traits<Allocator>::template rebind_alloc<list_type>;
+
+  using snapshot_traits = std::allocator_traits<snapshot_allocator_type>;
+
+  const list_type* new_snapshot_()
+  {
+    const auto p_list = snapshot_traits::allocate(snapshot_allocator_, 1);
+
+    try
+    {
+      snapshot_traits::construct(
+        snapshot_allocator_, std::addressof(*p_list), list_.snapshot());
+    }
+    catch (...)
+    {
+      snapshot_traits::deallocate(snapshot_allocator_, p_list, 1);
+      throw;
+    }
+
+    return std::addressof(*p_list);
+  }
+
+  void delete_snapshot_(const list_type* p_list)
+  {
+    const auto p = std::pointer_traits<typename snapshot_traits::pointer>::
+      pointer_to(const_cast<list_type&>(*p_list));
+
+    snapshot_traits::destroy(snapshot_allocator_, std::addressof(*p));
+    snapshot_traits::deallocate(snapshot_allocator_, p, 1);
+  }
+
+  void publish_()
+  {
+    if (retired_.size() == retired_.capacity())
+      retired_.reserve(2 * retired_.size());
+
+    const auto p_list = new_snapshot_();
+    const auto p_replaced = p_published_.exchange(p_list);
+
+    retired_.emplace_back(epoch_.advance(), p_replaced);
+
+    if (retired_.size() % reclaim_period == 0)
+      reclaim();
+  }
+
+private:
+  list_type list_;
+  snapshot_allocator_type snapshot_allocator_;
+  mutable epoch_domain epoch_;
+  std::atomic<const list_type*> p_published_;
+
+  // Replaced snapshots with their tags, oldest first
+  std::vector<std::pair<std::uint64_t, const list_type*>> retired_;
+};
+
+} // binary_tree
+
+} // dst
@@ -0,0 +1,371 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/epoch.h>
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+
+#include <algorithm>    // std::upper_bound
+#include <atomic>       // std::atomic
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <functional>   // std::less
+#include <memory>       // std::allocator, std::unique_ptr
+#include <mutex>        // std::unique_lock
+#include <shared_mutex> // std::shared_lock, std::shared_mutex
+#include <utility>      // std::move, std::pair
+#include <vector>
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+/// @class concurrent_set dst/binary_tree/concurrent_set.h
+/// Sorted set of unique keys that many threads may change at once. The keys are
+/// split by value into segments, each an indexed AVL tree under its own lock,
+/// so changes to keys in different segments proceed in parallel and readers of
+/// a segment share its lock. The directory of segments is immutable and
+/// replaced as a whole, and a thread pins an epoch (see `epoch_domain`) to read
+/// it, so operations on single keys write no memory shared by all the threads.
+/// A segment that grows beyond `segment_capacity` keys is split in two at its
+/// root in O(log n) time, which holds up the threads working on that segment
+/// and `size` and `for_each`. Segments are not merged when they shrink.
+/// Every insert and erase holds its segment's lock exclusively, so writers
+/// only scale when their keys are spread over the segments. Monotonically
+/// increasing keys all go to the last segment, and splitting it only moves
+/// the hot spot to the new last segment, so such writers run no faster than
+/// under a single mutex.
+/// The segments allocate through copies of the allocator from many threads
+/// at once, so the allocator must be safe to use from several threads at once
+/// (see `is_thread_safe_allocator`); for example, `pool_allocator` is not.
+template <typename Key,
+          typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<Key>>
+class concurrent_set
+{
+public:
+  using key_type = Key;
+  using value_type = Key;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using size_type = std::size_t;
+
+  static constexpr size_type segment_capacity = 4096;
+
+public:
+  explicit concurrent_set(const key_compare& compare = key_compare(),
+                          const allocator_type& allocator = allocator_type())
+  : compare_(compare)
+  , allocator_(allocator)
+  , directory_mutex_()
+  , segments_()
+  , epoch_()
+  , p_directory_(nullptr)
+  , retired_()
+  {
+    std::unique_ptr<segment> p_segment(new segment(list_type(allocator_)));
+    std::unique_ptr<directory> p_directory(new directory());
+
+    p_directory->segments.push_back(p_segment.get());
+    segments_.push_back(std::move(p_segment));
+
+    p_directory_.store(p_directory.release());
+  }
+
+  concurrent_set(const concurrent_set&) = delete;
+  concurrent_set& operator=(const concurrent_set&) = delete;
+
+  // No other thread may use the set
+  ~concurrent_set()
+  {
+    for (const auto& r : retired_)
+    {
+      delete r.second;
+    }
+
+    delete p_directory_.load();
+  }
+
+  allocator_type get_allocator() const
+  {
+    return allocator_;
+  }
+
+  key_compare key_comp() const
+  {
+    return compare_;
+  }
+
+  // Returns false if the key was in the set already
+  bool insert(const key_type& key)
+  {
+    bool full = false;
+
+    {
+      std::unique_lock<std::shared_mutex> lock;
+
+      auto& s = lock_segment_(key, lock);
+
+      const auto y = lower_bound_(s.keys, key);
+
+      if (y != s.keys.cnil() && !compare_(key, *y))
+        return false;
+
+      s.keys.insert(typename list_type::const_iterator(y), key);
+
+      full = s.keys.size() > segment_capacity;
+    }
+
+    if (full)
+      split_(key);
+
+    return true;
+  }
+
+  // Returns false if there was no such key
+  bool erase(const key_type& key)
+  {
+    std::unique_lock<std::shared_mutex> lock;
+
+    auto& s = lock_segment_(key, lock);
+
+    const auto y = lower_bound_(s.keys, key);
+
+    if (y == s.keys.cnil() || compare_(key, *y))
+      return false;
+
+    s.keys.erase(typename list_type::const_iterator(y));
+
+    return true;
+  }
+
+  bool contains(const key_type& key) const
+  {
+    std::shared_lock<std::shared_mutex> lock;
+
+    const auto& s = lock_segment_(key, lock);
+
+    const auto y = lower_bound_(s.keys, key);
+
+    return y != s.keys.cnil() && !compare_(key, *y);
+  }
+
+  // Exact only while no other thread changes the set
+  size_type size() const
+  {
+    std::shared_lock<std::shared_mutex> directory_lock(directory_mutex_);
+
+    size_type result = 0;
+
+    for (const auto p_segment : p_directory_.load()->segments)
+    {
+      std::shared_lock<std::shared_mutex> lock(p_segment->mutex);
+
+      result += p_segment->keys.size();
+    }
+
+    return result;
+  }
+
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  size_type segment_count() const
+  {
+    const auto guard = epoch_.pin();
+
+    return p_directory_.load()->segments.size();
+  }
+
+  // Calls `f` with the keys in order. Each segment is read under its lock,
+  // so `f` sees every segment as of some moment, but not the whole set.
+  template <typename Function> void for_each(Function f) const
+  {
+    std::shared_lock<std::shared_mutex> directory_lock(directory_mutex_);
+
+    for (const auto p_segment : p_directory_.load()->segments)
+    {
+      std::shared_lock<std::shared_mutex> lock(p_segment->mutex);
+
+      for (const auto& key : p_segment->keys)
+      {
+        f(key);
+      }
+    }
+  }
+
+private:
+  // Indexing keeps the size of the upper half at hand when splitting
+  using list_type = list<Key, Allocator, Indexing, AVL>;
+  using const_tree_iterator = typename list_type::const_tree_iterator;
+
+  struct segment
+  {
+    explicit segment(list_type&& keys)
+    : mutex()
+    , keys(std::move(keys))
+    , p_upper()
+    {
+    }
+
+    mutable std::shared_mutex mutex;
+    list_type keys;
+
+    // The least key of the next segment, none for the last one. Guarded by
+    // `mutex`, since a split lowers it.
+    std::unique_ptr<key_type> p_upper;
+  };
+
+  // Never changes once published; a split publishes a new one
+  struct directory
+  {
+    std::vector<segment*> segments;
+
+    // The least key of every segment but the first
+    std::vector<key_type> bounds;
+  };
+
+  std::size_t index_for_(const directory& d, const key_type& key) const
+  {
+    return static_cast<std::size_t>(
+      std::upper_bound(d.bounds.begin(), d.bounds.end(), key, compare_) -
+      d.bounds.begin());
+  }
+
+  segment& segment_for_(const key_type& key) const
+  {
+    const auto guard = epoch_.pin();
+    const auto& d = *p_directory_.load();
+
+    return *d.segments[index_for_(d, key)];
+  }
+
+  // Locks the segment of `key` with `lock`. A directory read just before a
+  // split leads to the lower half of the split segment, so the bound of the
+  // segment is checked under the lock and the lookup repeated if needed.
+  template <typename Lock>
+  segment& lock_segment_(const key_type& key, Lock& lock) const
+  {
+    for (;;)
+    {
+      auto& s = segment_for_(key);
+
+      lock = Lock(s.mutex);
+
+      if (!s.p_upper || compare_(key, *s.p_upper))
+        return s;
+
+      lock.unlock();
+    }
+  }
+
+  // The first key not less than `key`, nil if there is none
+  const_tree_iterator lower_bound_(const list_type& keys,
+                                   const key_type& key) const
+  {
+    auto result = keys.cnil();
+
+    for (auto x = keys.croot(); !!x;)
+    {
+      if (compare_(*x, key))
+      {
+        x = right(x);
+      }
+      else
+      {
+        result = x;
+        x = left(x);
+      }
+    }
+
+    return result;
+  }
+
+  // Splits the segment of `key` if no other thread has done so yet
+  void split_(const key_type& key)
+  {
+    std::unique_lock<std::shared_mutex> directory_lock(directory_mutex_);
+
+    // Only splits replace the directory, and they hold the lock
+    const auto& d = *p_directory_.load();
+    const auto i = index_for_(d, key);
+    auto& s = *d.segments[i];
+
+    std::unique_lock<std::shared_mutex> lock(s.mutex);
+
+    if (s.keys.size() <= segment_capacity)
+      return;
+
+    std::unique_ptr<segment> p_upper(new segment(list_type(allocator_)));
+
+    const auto middle = typename list_type::const_iterator(s.keys.croot());
+
+    std::unique_ptr<key_type> p_bound(new key_type(*middle));
+    std::unique_ptr<directory> p_next(new directory(d));
+
+    p_next->bounds.insert(p_next->bounds.begin() + i, *middle);
+    p_next->segments.insert(p_next->segments.begin() + i + 1, p_upper.get());
+
+    segments_.reserve(segments_.size() + 1);
+    retired_.reserve(retired_.size() + 1);
+
+    auto upper = s.keys.split(middle);
+
+    p_upper->keys.swap(upper);
+    p_upper->p_upper = std::move(s.p_upper);
+    s.p_upper = std::move(p_bound);
+
+    segments_.push_back(std::move(p_upper));
+
+    const auto p_replaced = p_directory_.exchange(p_next.release());
+
+    retired_.emplace_back(epoch_.advance(), p_replaced);
+
+    reclaim_();
+  }
+
+  // Frees the replaced directories that no thread can be reading any more
+  void reclaim_()
+  {
+    const auto oldest = epoch_.oldest();
+
+    auto it = retired_.begin();
+
+    for (; it != retired_.end() && it->first < oldest; ++it)
+    {
+      delete it->second;
+    }
+
+    retired_.erase(retired_.begin(), it);
+  }
+
+private:
+  key_compare compare_;
+  allocator_type allocator_;
+
+  // Held by splits, which replace the directory, and by the members which
+  // go through all the segments
+  mutable std::shared_mutex directory_mutex_;
+
+  // All the segments in no particular order, guarded by `directory_mutex_`
+  std::vector<std::unique_ptr<segment>> segments_;
+
+  mutable epoch_domain epoch_;
+  std::atomic<const directory*> p_directory_;
+
+  // Replaced directories with their tags, oldest first
+  std::vector<std::pair<std::uint64_t, const directory*>> retired_;
+};
+
+} // binary_tree
+
+} // dst
@@ -0,0 +1,142 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <array>      // std::array
+#include <atomic>     // std::atomic
+#include <cstddef>    // std::size_t
+#include <cstdint>    // std::uint64_t
+#include <functional> // std::hash
+#include <limits>     // std::numeric_limits
+#include <thread>     // std::this_thread
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+// Epoch based reclamation for structures with one writer and any number of
+// readers. A reader pins the current epoch for as long as it follows
+// pointers into the structure. The writer unlinks an object, calls
+// `advance()` and keeps the returned tag with the object; the object may be
+// freed once `oldest()` is greater than the tag, since every reader pinned
+// since then started after the object was unlinked.
+class epoch_domain
+{
+public:
+  // Readers pinned at once; one more waits until a reader leaves
+  static constexpr std::size_t max_readers = 128;
+
+  class guard
+  {
+  public:
+    guard(guard&& other)
+    : p_domain_(other.p_domain_)
+    , slot_(other.slot_)
+    {
+      other.p_domain_ = nullptr;
+    }
+
+    guard(const guard&) = delete;
+    guard& operator=(const guard&) = delete;
+
+    ~guard()
+    {
+      if (p_domain_ != nullptr)
+        p_domain_->slots_[slot_].epoch.store(0);
+    }
+
+  private:
+    friend epoch_domain;
+
+    guard(epoch_domain& domain, std::size_t slot)
+    : p_domain_(&domain)
+    , slot_(slot)
+    {
+    }
+
+  private:
+    epoch_domain* p_domain_;
+    std::size_t slot_;
+  };
+
+public:
+  epoch_domain()
+  : epoch_(1)
+  , slots_()
+  {
+    for (auto& s : slots_)
+    {
+      s.epoch.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  epoch_domain(const epoch_domain&) = delete;
+  epoch_domain& operator=(const epoch_domain&) = delete;
+
+  // Pins the current epoch until the guard is destroyed
+  guard pin()
+  {
+    const auto start = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    for (;;)
+    {
+      for (std::size_t i = 0; i < max_readers; ++i)
+      {
+        const auto k = (start + i) % max_readers;
+
+        std::uint64_t expected = 0;
+
+        if (slots_[k].epoch.load(std::memory_order_relaxed) == 0 &&
+            slots_[k].epoch.compare_exchange_strong(expected, epoch_.load()))
+        {
+          return guard(*this, k);
+        }
+      }
+
+      std::this_thread::yield();
+    }
+  }
+
+  // Starts a new epoch, returns the tag for the objects unlinked so far
+  std::uint64_t advance()
+  {
+    return epoch_.fetch_add(1);
+  }
+
+  // The earliest epoch pinned by a reader, the maximum value if none is
+  std::uint64_t oldest() const
+  {
+    auto result = std::numeric_limits<std::uint64_t>::max();
+
+    for (const auto& s : slots_)
+    {
+      const auto e = s.epoch.load();
+
+      if (e != 0 && e < result)
+        result = e;
+    }
+
+    return result;
+  }
+
+private:
+  // A cache line per reader, so that readers do not slow each other down
+  struct alignas(64) slot
+  {
+    std::atomic<std::uint64_t> epoch;
+  };
+
+  // Its own cache line too, since the writer bumps it while readers pin
+  alignas(64) std::atomic<std::uint64_t> epoch_;
+  std::array<slot, max_readers> slots_;
+};
+
+} // binary_tree
+
+} // dst
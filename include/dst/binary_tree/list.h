@@ -27,8 +27,13 @@ private:
   using base = typename fold_mixins<Binary, Mixin, Mixins...>::
     template type<T, void, Allocator>;
 
-  static_assert(is_balanced_binary_tree<typename base::tree_category>::value,
-                "Must be balanced");
+  static_assert(
+    is_balanced_binary_tree<typename base::tree_category>::value ||
+      is_self_adjusting_binary_tree<typename base::tree_category>::value,
+    "Must be balanced or self-adjusting");
+
+  using joinable =
+    is_joinable_binary_tree<typename base::tree_category>;
 
 public:
   using typename base::const_tree_iterator;
@@ -55,9 +60,11 @@ public:
   using base::empty;
   using base::end;
   using base::get_allocator;
+  using base::get_parallel_policy;
   using base::max_size;
   using base::nil;
   using base::root;
+  using base::set_parallel_policy;
   using base::size;
 
 public:
@@ -115,7 +122,7 @@ public:
        const allocator_type& allocator = allocator_type())
   : list(allocator)
   {
-    std::copy(std::begin(init), std::end(init), std::back_inserter(*this));
+    insert(cend(), std::begin(init), std::end(init));
   }
 
   list& operator=(const std::initializer_list<value_type>& init)
@@ -180,27 +187,11 @@ public:
             typename = enable_for_input_iterator<InputIterator>>
   iterator insert(const_iterator position, InputIterator from, InputIterator to)
   {
-    auto pos = iterator(base::iterator_const_cast(position.base()));
-
-    try
-    {
-      if (from != to)
-      {
-        pos = emplace(position, *(from++));
-      }
-
-      for (; from != to; ++from)
-      {
-        emplace(position, *from);
-      }
-    }
-    catch (...)
-    {
-      erase(pos, position);
-      throw;
-    }
-
-    return pos;
+    return insert_(
+      position,
+      from,
+      to,
+      typename std::iterator_traits<InputIterator>::iterator_category());
   }
 
   template <typename... Args>
@@ -276,10 +267,7 @@ public:
 
   iterator erase(const_iterator from, const_iterator to)
   {
-    while (from != to)
-    {
-      erase(from++);
-    }
+    erase_(from, to, joinable());
 
     return iterator(base::iterator_const_cast(to.base()));
   }
@@ -402,6 +390,78 @@ public:
     lhs.swap(rhs);
   }
 
+  // Moves the elements starting from `position` to a new list. Takes
+  // O(log n) time, plus time linear in the number of moved elements unless
+  // the tree is augmented with `Indexing`.
+  list split(const_iterator position)
+  {
+    static_assert(joinable::value, "Must be joinable");
+
+    list result(base::get_allocator());
+
+    if (position == cend())
+      return result;
+
+    const auto pieces = base::split(position.base());
+
+    base::link_right(nil(), pieces.first);
+
+    result.adopt(*this, pieces.second, base::subtree_size(pieces.second));
+    result.link_right(result.nil(), pieces.second);
+
+    return result;
+  }
+
+  // Moves all the elements of `other` in front of `position` in
+  // O(log n + log m) time. The allocators must compare equal.
+  void splice(const_iterator position, list& other)
+  {
+    static_assert(joinable::value, "Must be joinable");
+
+    assert(&other != this);
+
+    if (other.empty())
+      return;
+
+    const auto y = other.root();
+
+    other.unlink(y);
+    base::adopt(other, y, size_type(other.size()));
+
+    if (position == cend())
+    {
+      const auto x = root();
+
+      if (!!x)
+        base::unlink(x);
+
+      base::link_right(nil(), base::join(x, y));
+    }
+    else
+    {
+      const auto pieces = base::split(position.base());
+
+      base::link_right(
+        nil(), base::join(base::join(pieces.first, y), pieces.second));
+    }
+  }
+
+  void splice(const_iterator position, list&& other)
+  {
+    splice(position, other);
+  }
+
+  // Appends all the elements of `other` in O(log n + log m) time.
+  void join(list& other)
+  {
+    splice(cend(), other);
+  }
+
+  void join(list&& other)
+  {
+    splice(cend(), other);
+  }
+
   template <typename Predicate> void remove_if(Predicate p)
   {
     auto position = cbegin();
@@ -437,6 +497,110 @@ public:
   {
     std::reverse(begin(), end());
   }
+
+private:
+  // Cuts [from, to) out with two splits and a join, then frees the removed
+  // nodes in a single traversal, so it takes O(k + log n) time.
+  void erase_(const_iterator from,
+              const_iterator to,
+              std::true_type)
+  {
+    if (from == to)
+      return;
+
+    tree_iterator tail;
+
+    if (to != cend())
+    {
+      const auto pieces = base::split(to.base());
+
+      base::link_right(nil(), pieces.first);
+      tail = pieces.second;
+    }
+
+    const auto pieces = base::split(from.base());
+
+    base::erase_detached(pieces.second);
+    base::link_right(nil(), base::join(pieces.first, tail));
+  }
+
+  void erase_(const_iterator from, const_iterator to, std::false_type)
+  {
+    while (from != to)
+    {
+      erase(from++);
+    }
+  }
+
+  template <typename ForwardIterator>
+  iterator insert_(const_iterator position,
+                   ForwardIterator from,
+                   ForwardIterator to,
+                   std::forward_iterator_tag)
+  {
+    if (!empty())
+      return insert_(position, from, to, joinable());
+
+    base::build(from, static_cast<size_type>(std::distance(from, to)));
+
+    return begin();
+  }
+
+  template <typename ForwardIterator>
+  iterator insert_(const_iterator position,
+                   ForwardIterator from,
+                   ForwardIterator to,
+                   std::true_type)
+  {
+    list l(from, to, base::get_allocator());
+
+    if (l.empty())
+      return iterator(base::iterator_const_cast(position.base()));
+
+    const auto first = l.begin();
+
+    splice(position, l);
+
+    return iterator(base::iterator_const_cast(first.base()));
+  }
+
+  template <typename ForwardIterator>
+  iterator insert_(const_iterator position,
+                   ForwardIterator from,
+                   ForwardIterator to,
+                   std::false_type)
+  {
+    return insert_(position, from, to, std::input_iterator_tag());
+  }
+
+  template <typename InputIterator>
+  iterator insert_(const_iterator position,
+                   InputIterator from,
+                   InputIterator to,
+                   std::input_iterator_tag)
+  {
+    auto pos = iterator(base::iterator_const_cast(position.base()));
+
+    try
+    {
+      if (from != to)
+      {
+        pos = emplace(position, *(from++));
+      }
+
+      for (; from != to; ++from)
+      {
+        emplace(position, *from);
+      }
+    }
+    catch (...)
+    {
+      erase(pos, position);
+      throw;
+    }
+
+    return pos;
+  }
 };
 
 } // binary_tree
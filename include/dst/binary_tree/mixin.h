@@ -6,7 +6,7 @@
 
 #pragma once
 
-#include <type_traits> // std::is_convertible
+#include <type_traits> // std::integral_constant, std::is_convertible
 
 namespace dst
 {
@@ -22,6 +22,21 @@ struct balanced_binary_tree_tag
 {
 };
 
+struct joinable_balanced_binary_tree_tag : public balanced_binary_tree_tag
+{
+};
+
+// Trees whose operations take O(log n) amortized time, while a single path
+// may be as long as the tree (e.g. splay trees)
+struct self_adjusting_binary_tree_tag
+{
+};
+
+struct joinable_self_adjusting_binary_tree_tag
+: public self_adjusting_binary_tree_tag
+{
+};
+
 namespace detail
 {
 
@@ -102,6 +117,26 @@ template <typename TreeCategory>
 using is_balanced_binary_tree =
   std::is_convertible<TreeCategory, binary_tree::balanced_binary_tree_tag>;
 
+template <typename TreeCategory>
+using is_joinable_balanced_binary_tree =
+  std::is_convertible<TreeCategory,
+                      binary_tree::joinable_balanced_binary_tree_tag>;
+
+template <typename TreeCategory>
+using is_self_adjusting_binary_tree =
+  std::is_convertible<TreeCategory,
+                      binary_tree::self_adjusting_binary_tree_tag>;
+
+// Balanced or self-adjusting tree which can be split and joined in
+// O(log n) (amortized) time
+template <typename TreeCategory>
+using is_joinable_binary_tree = std::integral_constant<
+  bool,
+  is_joinable_balanced_binary_tree<TreeCategory>::value ||
+    std::is_convertible<
+      TreeCategory,
+      binary_tree::joinable_self_adjusting_binary_tree_tag>::value>;
+
 template <typename TreeCategory>
 using is_unbalanced_binary_tree =
   std::is_convertible<TreeCategory, binary_tree::unbalanced_binary_tree_tag>;
@@ -0,0 +1,476 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/algorithm.h>
+#include <dst/binary_tree/initializer_tree.h>
+#include <dst/binary_tree/mixin.h>
+#include <dst/utility.h>
+
+#include <cassert> // assert
+#include <limits>  // std::numeric_limits
+#include <utility> // std::forward, std::move
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+template <typename T> class sum_monoid
+{
+public:
+  using summary_type = T;
+
+  static summary_type identity()
+  {
+    return summary_type();
+  }
+
+  static summary_type summarize(const T& value)
+  {
+    return value;
+  }
+
+  static summary_type combine(const summary_type& lhs,
+                              const summary_type& rhs)
+  {
+    return lhs + rhs;
+  }
+};
+
+template <typename T> class min_monoid
+{
+public:
+  using summary_type = T;
+
+  static summary_type identity()
+  {
+    return std::numeric_limits<T>::max();
+  }
+
+  static summary_type summarize(const T& value)
+  {
+    return value;
+  }
+
+  static summary_type combine(const summary_type& lhs,
+                              const summary_type& rhs)
+  {
+    return rhs < lhs ? rhs : lhs;
+  }
+};
+
+template <typename T> class max_monoid
+{
+public:
+  using summary_type = T;
+
+  static summary_type identity()
+  {
+    return std::numeric_limits<T>::lowest();
+  }
+
+  static summary_type summarize(const T& value)
+  {
+    return value;
+  }
+
+  static summary_type combine(const summary_type& lhs,
+                              const summary_type& rhs)
+  {
+    return lhs < rhs ? rhs : lhs;
+  }
+};
+
+namespace mixin
+{
+
+// Keeps the summary of every subtree, i.e. the in-order fold of its elements
+// with the monoid. `Monoid` provides `summary_type` and the static functions
+// `identity()`, `summarize(value)` and `combine(lhs, rhs)`; `combine` must be
+// associative, but need not be commutative.
+template <typename Monoid,
+          typename T,
+          typename M,
+          typename Allocator,
+          template <typename, typename, typename>
+          class Base>
+class aggregating
+: public Base<T, pair_or_single<typename Monoid::summary_type, M>, Allocator>
+{
+private:
+  using base =
+    Base<T, pair_or_single<typename Monoid::summary_type, M>, Allocator>;
+
+  static_assert(is_unbalanced_binary_tree<typename base::tree_category>::value,
+                "Base mixin must be unbalanced");
+
+protected:
+  using typename base::const_tree_iterator;
+  using typename base::tree_iterator;
+
+  using typename base::const_iterator;
+  using typename base::iterator;
+
+  using typename base::size_type;
+
+  using allocator_type = typename base::allocator_type;
+
+public:
+  using summary_type = typename Monoid::summary_type;
+
+public:
+  static summary_type subtree_summary(const_tree_iterator x)
+  {
+    return !x ? Monoid::identity() : summary(x);
+  }
+
+  // Summary of the elements preceding `position`.
+  summary_type prefix_query(const_tree_iterator position) const
+  {
+    if (!position)
+      return subtree_summary(base::root());
+
+    return prefix(position, const_tree_iterator());
+  }
+
+  summary_type prefix_query(const_iterator position) const
+  {
+    return prefix_query(position.base());
+  }
+
+  // Summary of the elements in [from, to). `from` must not follow `to`.
+  summary_type range_query(const_tree_iterator from,
+                           const_tree_iterator to) const
+  {
+    if (from == to)
+      return Monoid::identity();
+
+    assert(!!from);
+
+    if (!to)
+      return suffix(from, const_tree_iterator());
+
+    const auto c = common_ancestor(from, to);
+
+    auto result = from == c ? Monoid::identity() : suffix(from, c);
+
+    if (to != c)
+    {
+      result = Monoid::combine(result, Monoid::summarize(*c));
+      result = Monoid::combine(result, prefix(to, c));
+    }
+
+    return result;
+  }
+
+  summary_type range_query(const_iterator from, const_iterator to) const
+  {
+    return range_query(from.base(), to.base());
+  }
+
+  // First position whose inclusive prefix summary satisfies `p`, or the end if
+  // none does. `p` must be monotone: false for shorter prefixes, then true.
+  template <typename Predicate>
+  const_iterator lower_bound_by_prefix(Predicate p) const
+  {
+    return const_iterator(find_by_prefix(base::root(), p));
+  }
+
+  template <typename Predicate> iterator lower_bound_by_prefix(Predicate p)
+  {
+    return iterator(
+      base::iterator_const_cast(find_by_prefix(base::root(), p)));
+  }
+
+  // The element covering weight `w`, i.e. the first one whose inclusive
+  // prefix exceeds `w`. Its own offset is `prefix_query` of the result.
+  const_iterator element_at_weight(const summary_type& w) const
+  {
+    return lower_bound_by_prefix(
+      [&w](const summary_type& s) { return w < s; });
+  }
+
+  iterator element_at_weight(const summary_type& w)
+  {
+    return lower_bound_by_prefix(
+      [&w](const summary_type& s) { return w < s; });
+  }
+
+  // Must be called after the element at `position` was modified in place.
+  void update(const_tree_iterator position)
+  {
+    update_path(position);
+  }
+
+  void update(const_iterator position)
+  {
+    update(position.base());
+  }
+
+protected:
+  aggregating()
+  : base()
+  {
+  }
+
+  explicit aggregating(const allocator_type& allocator)
+  : base(allocator)
+  {
+  }
+
+  explicit aggregating(const aggregating& other,
+                       const allocator_type& allocator)
+  : base(other, allocator)
+  {
+  }
+
+  aggregating(aggregating&& other, const allocator_type& allocator)
+  : base(std::move(other), allocator)
+  {
+  }
+
+  aggregating(const initializer_tree<T>& init, const allocator_type& allocator)
+  : base(init, allocator)
+  {
+    update_all();
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_left(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_left(position, std::forward<Args>(args)...);
+
+    update_path(x);
+
+    return x;
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_right(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_right(position, std::forward<Args>(args)...);
+
+    update_path(x);
+
+    return x;
+  }
+
+  template <typename ForwardIterator>
+  void build(ForwardIterator from, size_type n)
+  {
+    base::build(from, n);
+
+    update_all();
+  }
+
+  void erase(const_tree_iterator position, const_tree_iterator sub)
+  {
+    const auto p = parent(sub) == position ? sub : parent(sub);
+
+    base::erase(position, sub);
+
+    update_path(p);
+  }
+
+  void erase(const_tree_iterator position)
+  {
+    const auto p = parent(position);
+
+    base::erase(position);
+
+    update_path(p);
+  }
+
+  void link_left(const_tree_iterator position, const_tree_iterator x)
+  {
+    base::link_left(position, x);
+
+    update_path(position);
+  }
+
+  void link_right(const_tree_iterator position, const_tree_iterator x)
+  {
+    base::link_right(position, x);
+
+    update_path(position);
+  }
+
+  void unlink(const_tree_iterator x)
+  {
+    const auto p = parent(x);
+
+    base::unlink(x);
+
+    update_path(p);
+  }
+
+  tree_iterator rotate_left(const_tree_iterator x)
+  {
+    const auto y = base::rotate_left(x);
+
+    update_node(x);
+    update_node(y);
+
+    return y;
+  }
+
+  tree_iterator rotate_right(const_tree_iterator x)
+  {
+    const auto y = base::rotate_right(x);
+
+    update_node(x);
+    update_node(y);
+
+    return y;
+  }
+
+  static typename ref_or_void<M>::type metadata(const_tree_iterator x)
+  {
+    return base::metadata(x).second();
+  }
+
+private:
+  static summary_type& summary(const_tree_iterator x)
+  {
+    return base::metadata(x).first();
+  }
+
+  static void update_node(const_tree_iterator x)
+  {
+    summary(x) = Monoid::combine(
+      Monoid::combine(subtree_summary(left(x)), Monoid::summarize(*x)),
+      subtree_summary(right(x)));
+  }
+
+  static void update_path(const_tree_iterator x)
+  {
+    for (auto it = x; !!it; ++it)
+    {
+      update_node(it);
+    }
+  }
+
+  void update_all()
+  {
+    const auto it_end = end_postorder_depth_first_search(base::nil());
+    for (auto it = begin_postorder_depth_first_search(base::root());
+         it != it_end;
+         ++it)
+    {
+      update_node(it.base());
+    }
+  }
+
+  // Summary of the elements from `x` up to the end of the subtree of `stop`'s
+  // child containing `x`, or of the tree if `stop` is nil.
+  static summary_type suffix(const_tree_iterator x, const_tree_iterator stop)
+  {
+    auto result =
+      Monoid::combine(Monoid::summarize(*x), subtree_summary(right(x)));
+
+    for (auto p = parent(x); !!p && p != stop; x = p, p = parent(x))
+    {
+      if (left(p) == x)
+      {
+        result = Monoid::combine(
+          result,
+          Monoid::combine(Monoid::summarize(*p), subtree_summary(right(p))));
+      }
+    }
+
+    return result;
+  }
+
+  // Summary of the elements preceding `x` in the subtree of `stop`'s child
+  // containing `x`, or in the tree if `stop` is nil.
+  static summary_type prefix(const_tree_iterator x, const_tree_iterator stop)
+  {
+    auto result = subtree_summary(left(x));
+
+    for (auto p = parent(x); !!p && p != stop; x = p, p = parent(x))
+    {
+      if (right(p) == x)
+      {
+        result = Monoid::combine(
+          Monoid::combine(subtree_summary(left(p)), Monoid::summarize(*p)),
+          result);
+      }
+    }
+
+    return result;
+  }
+
+  template <typename Predicate>
+  const_tree_iterator find_by_prefix(const_tree_iterator x, Predicate p) const
+  {
+    auto prefix = Monoid::identity();
+
+    while (!!x)
+    {
+      const auto before_x = Monoid::combine(prefix, subtree_summary(left(x)));
+
+      if (p(before_x))
+      {
+        x = left(x);
+        continue;
+      }
+
+      prefix = Monoid::combine(before_x, Monoid::summarize(*x));
+
+      if (p(prefix))
+        return x;
+
+      x = right(x);
+    }
+
+    return base::nil();
+  }
+
+  static const_tree_iterator common_ancestor(const_tree_iterator x,
+                                             const_tree_iterator y)
+  {
+    auto x_depth = depth(x);
+    auto y_depth = depth(y);
+
+    for (; x_depth > y_depth; --x_depth)
+    {
+      ++x;
+    }
+
+    for (; y_depth > x_depth; --y_depth)
+    {
+      ++y;
+    }
+
+    while (x != y)
+    {
+      ++x;
+      ++y;
+    }
+
+    return x;
+  }
+};
+
+} // mixin
+
+template <typename Monoid> class Aggregating
+{
+public:
+  template <typename T,
+            typename M,
+            typename Allocator,
+            template <typename, typename, typename>
+            class Base>
+  using type = mixin::aggregating<Monoid, T, M, Allocator, Base>;
+};
+
+} // binary_tree
+
+} // dst
@@ -8,9 +8,13 @@
 
 #include <dst/utility.h>
 
+#include <algorithm> // std::max
+#include <array>
 #include <cassert>
 #include <cstdint>
-#include <tuple> // std::tie
+#include <limits>
+#include <tuple>   // std::tie
+#include <utility> // std::pair
 
 namespace dst
 {
@@ -35,11 +39,13 @@ private:
                 "Base mixin must be unbalanced");
 
 protected:
-  using tree_category = balanced_binary_tree_tag;
+  using tree_category = joinable_balanced_binary_tree_tag;
 
   using typename base::const_tree_iterator;
   using typename base::tree_iterator;
 
+  using typename base::size_type;
+
   using allocator_type = typename base::allocator_type;
 
 protected:
@@ -106,6 +112,133 @@ protected:
     after_erasing(p, left_erasing);
   }
 
+  template <typename ForwardIterator>
+  void build(ForwardIterator from, size_type n)
+  {
+    base::build(from, n);
+
+    build_balance_factors(base::root());
+  }
+
+  // Joins the detached trees `x` and `y` through the detached node `k`, which
+  // goes between them. Returns the root of the resulting detached tree.
+  tree_iterator
+  join(const_tree_iterator x, const_tree_iterator k, const_tree_iterator y)
+  {
+    return join(x, height(x), k, y, height(y)).first;
+  }
+
+  // Concatenates the detached trees `x` and `y`. Returns the root of the
+  // resulting detached tree.
+  tree_iterator join(const_tree_iterator x, const_tree_iterator y)
+  {
+    if (!x)
+      return base::iterator_const_cast(y);
+
+    if (!y)
+      return base::iterator_const_cast(x);
+
+    const auto k = minimum(y);
+
+    auto rest = right(k);
+
+    if (!!rest)
+      base::unlink(rest);
+
+    if (k != y)
+    {
+      const auto p = parent(k);
+
+      base::unlink(k);
+      base::link_left(p, rest);
+
+      after_erasing(p, true);
+
+      for (rest = p; !!parent(rest); rest = parent(rest))
+      {
+      }
+    }
+
+    return join(x, height(x), k, rest, height(rest)).first;
+  }
+
+  // Splits the tree containing `k` into two detached trees: the elements
+  // before `k` and the elements starting from `k`.
+  std::pair<tree_iterator, tree_iterator> split(const_tree_iterator k)
+  {
+    assert(!!k);
+
+    struct path_node
+    {
+      const_tree_iterator x;
+      const_tree_iterator other;
+      int other_height;
+      bool went_left;
+    };
+
+    std::array<path_node, max_height> path;
+    std::size_t depth = 0;
+
+    for (auto x = k; !!x; ++x)
+    {
+      assert(depth < max_height);
+
+      path[depth++].x = x;
+    }
+
+    int h = height(path[depth - 1].x);
+
+    for (std::size_t i = depth - 1; i > 0; --i)
+    {
+      auto& n = path[i];
+
+      n.went_left = left(n.x) == path[i - 1].x;
+      n.other = n.went_left ? right(n.x) : left(n.x);
+
+      const int left_height = h - 1 - (bf(n.x) > 0);
+      const int right_height = h - 1 - (bf(n.x) < 0);
+
+      n.other_height = n.went_left ? right_height : left_height;
+      h = n.went_left ? left_height : right_height;
+    }
+
+    const auto k_left = left(k);
+    const auto k_right = right(k);
+    const int k_left_height = h - 1 - (bf(k) > 0);
+    const int k_right_height = h - 1 - (bf(k) < 0);
+
+    base::unlink(path[depth - 1].x);
+
+    for (std::size_t i = depth - 1; i > 0; --i)
+    {
+      base::unlink(path[i - 1].x);
+
+      if (!!path[i].other)
+        base::unlink(path[i].other);
+    }
+
+    if (!!k_left)
+      base::unlink(k_left);
+
+    if (!!k_right)
+      base::unlink(k_right);
+
+    auto l = std::make_pair(base::iterator_const_cast(k_left), k_left_height);
+    auto r = join(base::nil(), 0, k, k_right, k_right_height);
+
+    for (std::size_t i = 1; i < depth; ++i)
+    {
+      const auto& n = path[i];
+
+      if (n.went_left)
+        r = join(r.first, r.second, n.x, n.other, n.other_height);
+      else
+        l = join(n.other, n.other_height, n.x, l.first, l.second);
+    }
+
+    return std::make_pair(l.first, r.first);
+  }
+
   static typename ref_or_void<M>::type metadata(const_tree_iterator x)
   {
     return base::metadata(x).second();
@@ -118,12 +251,123 @@ public:
   }
 
 private:
+  // AVL tree height never exceeds 1.44 * log2(n + 2)
+  static constexpr std::size_t max_height =
+    std::numeric_limits<size_type>::digits * 3 / 2;
+
   std::int8_t& bf(const_tree_iterator x)
   {
     return base::metadata(x).first();
   }
 
-  void after_insertion(const_tree_iterator x, bool left_insertion)
+  static int height(const_tree_iterator x)
+  {
+    int h = 0;
+
+    for (; !!x; ++h)
+    {
+      x = balance_factor(x) < 0 ? left(x) : right(x);
+    }
+
+    return h;
+  }
+
+  std::pair<tree_iterator, int> join(const_tree_iterator x,
+                                     int x_height,
+                                     const_tree_iterator k,
+                                     const_tree_iterator y,
+                                     int y_height)
+  {
+    assert(!!k && !left(k) && !right(k) && !parent(k));
+
+    if (x_height > y_height + 1)
+    {
+      auto p = x;
+      auto c = x;
+      int c_height = x_height;
+
+      while (c_height > y_height + 1)
+      {
+        p = c;
+        c_height -= bf(c) < 0 ? 2 : 1;
+        c = right(c);
+      }
+
+      if (!!c)
+        base::unlink(c);
+
+      base::link_left(k, c);
+      base::link_right(k, y);
+      bf(k) = static_cast<std::int8_t>(y_height - c_height);
+      base::link_right(p, k);
+
+      const bool grown = after_insertion(p, false);
+
+      return std::make_pair(top(k), x_height + grown);
+    }
+
+    if (y_height > x_height + 1)
+    {
+      auto p = y;
+      auto c = y;
+      int c_height = y_height;
+
+      while (c_height > x_height + 1)
+      {
+        p = c;
+        c_height -= bf(c) > 0 ? 2 : 1;
+        c = left(c);
+      }
+
+      if (!!c)
+        base::unlink(c);
+
+      base::link_right(k, c);
+      base::link_left(k, x);
+      bf(k) = static_cast<std::int8_t>(c_height - x_height);
+      base::link_left(p, k);
+
+      const bool grown = after_insertion(p, true);
+
+      return std::make_pair(top(k), y_height + grown);
+    }
+
+    base::link_left(k, x);
+    base::link_right(k, y);
+    bf(k) = static_cast<std::int8_t>(y_height - x_height);
+
+    return std::make_pair(base::iterator_const_cast(k),
+                          std::max(x_height, y_height) + 1);
+  }
+
+  tree_iterator top(const_tree_iterator x)
+  {
+    while (!!parent(x))
+    {
+      x = parent(x);
+    }
+
+    return base::iterator_const_cast(x);
+  }
+
+  // Sets the balance factors of a freshly built subtree, returns its height
+  int build_balance_factors(const_tree_iterator x)
+  {
+    if (!x)
+      return 0;
+
+    const int left_height = build_balance_factors(left(x));
+    const int right_height = build_balance_factors(right(x));
+
+    bf(x) = static_cast<std::int8_t>(right_height - left_height);
+
+    assert(bf(x) >= -1 && bf(x) <= 1);
+
+    return std::max(left_height, right_height) + 1;
+  }
+
+  // Returns `true` if the height of the whole tree has grown
+  bool after_insertion(const_tree_iterator x, bool left_insertion)
   {
     while (!!x)
     {
@@ -136,11 +380,13 @@ private:
       std::tie(x, height_changed) = rebalance(x);
 
       if (height_changed)
-        break;
+        return false;
 
       left_insertion = !!parent(x) && left(parent(x)) == x;
       x = parent(x);
     }
+
+    return true;
   }
 
   void after_erasing(const_tree_iterator x, bool left_erasing)
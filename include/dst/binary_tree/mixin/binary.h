@@ -10,13 +10,16 @@
 #include <dst/binary_tree/algorithm.h>
 #include <dst/binary_tree/initializer_tree.h>
 #include <dst/binary_tree/mixin.h>
+#include <dst/binary_tree/parallel_policy.h>
 #include <dst/utility.h>
 
 #include <algorithm> // std::min
 #include <cassert>
+#include <future> // std::async, std::future
 #include <iterator>
 #include <limits>
 #include <memory> // std::allocator_traits
+#include <system_error>
 #include <type_traits>
 #include <utility>
 
@@ -42,8 +45,12 @@ private:
 
   struct node;
 
-  using node_pointer = typename std::allocator_traits<
-    Allocator>::template rebind_traits<node>::pointer;
+  using node_allocator_type =
+    typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+
+  using node_traits = std::allocator_traits<node_allocator_type>;
+
+  using node_pointer = typename node_traits::pointer;
 
   struct links
   {
@@ -232,16 +239,20 @@ protected:
 protected:
   binary()
   : allocator_type()
+  , node_allocator_(static_cast<const allocator_type&>(*this))
   , size_(0)
   , p_nil_()
+  , parallel_policy_()
   {
     p_nil_ = new_nil_node_();
   }
 
   explicit binary(const allocator_type& allocator)
   : allocator_type(allocator)
+  , node_allocator_(allocator)
   , size_(0)
   , p_nil_()
+  , parallel_policy_()
   {
     p_nil_ = new_nil_node_();
   }
@@ -262,7 +273,10 @@ protected:
   explicit binary(const binary& other, const allocator_type& allocator)
   : binary(allocator)
   {
-    p_nil_->right() = copy_subtree_(other.root(), p_nil_);
+    parallel_policy_ = other.parallel_policy_;
+
+    set_root_(copy_subtree_(other.root(), p_nil_, threads_for_(other.size_)));
+    size_ = other.size_;
   }
 
   binary(binary&& other, const allocator_type& allocator)
@@ -274,14 +288,17 @@ protected:
     }
     else
     {
-      p_nil_->right() = move_subtree_(other.root(), p_nil_);
+      parallel_policy_ = other.parallel_policy_;
+
+      set_root_(move_subtree_(other.root(), p_nil_, threads_for_(other.size_)));
+      size_ = other.size_;
     }
   }
 
   binary(const initializer_tree<T>& init, const allocator_type& allocator)
   : binary(allocator)
   {
-    p_nil_->right() = copy_subtree_(init.root(), p_nil_);
+    set_root_(copy_subtree_(init.root(), p_nil_));
   }
 
   ~binary() noexcept(
@@ -375,7 +392,7 @@ protected:
       assert(!root());
 
       p_node->right() =
-        new_node_(p_node, p_nil_, p_nil_, std::forward<Args>(args)...);
+        new_node_(p_node, nullptr, nullptr, std::forward<Args>(args)...);
 
       return tree_iterator(p_node->right());
     }
@@ -383,7 +400,7 @@ protected:
     assert(!left(position));
 
     p_node->left() =
-      new_node_(p_node, p_nil_, p_nil_, std::forward<Args>(args)...);
+      new_node_(p_node, nullptr, nullptr, std::forward<Args>(args)...);
 
     return tree_iterator(p_node->left());
   }
@@ -398,7 +415,7 @@ protected:
       assert(!root());
 
       p_node->right() =
-        new_node_(p_node, p_nil_, p_nil_, std::forward<Args>(args)...);
+        new_node_(p_node, nullptr, nullptr, std::forward<Args>(args)...);
 
       return tree_iterator(p_node->right());
     }
@@ -406,7 +423,7 @@ protected:
     assert(!right(position));
 
     p_node->right() =
-      new_node_(p_node, p_nil_, p_nil_, std::forward<Args>(args)...);
+      new_node_(p_node, nullptr, nullptr, std::forward<Args>(args)...);
 
     return tree_iterator(p_node->right());
   }
@@ -424,30 +441,24 @@ protected:
 
     assert((p_y_parent->left() == p_y) != (p_y_parent->right() == p_y));
 
-    const auto p_y_child = p_y->left() != p_nil_ ? p_y->left() : p_y->right();
+    const auto p_y_child = p_y->left() != nullptr ? p_y->left() : p_y->right();
 
-    if (p_y_parent->left() == p_y)
-      p_y_parent->left() = p_y_child;
-    else
-      p_y_parent->right() = p_y_child;
-
-    p_y_child->parent() = p_y_parent;
+    replace_child_(p_y_parent, p_y, p_y_child);
 
     p_y->left() = p_x->left();
     p_y->right() = p_x->right();
-    p_y->parent() = p_x->parent();
 
     const auto p_x_parent = p_x->parent();
 
     assert((p_x_parent->left() == p_x) != (p_x_parent->right() == p_x));
 
-    if (p_x_parent->left() == p_x)
-      p_x_parent->left() = p_y;
-    else
-      p_x_parent->right() = p_y;
+    replace_child_(p_x_parent, p_x, p_y);
+
+    if (p_y->left() != nullptr)
+      p_y->left()->parent() = p_y;
 
-    p_x->right()->parent() = p_y;
-    p_x->left()->parent() = p_y;
+    if (p_y->right() != nullptr)
+      p_y->right()->parent() = p_y;
 
     swap_metadata_(p_x->data, p_y->data);
 
@@ -466,14 +477,9 @@ protected:
 
     assert((p_x_parent->left() == p_x) != (p_x_parent->right() == p_x));
 
-    const auto p_x_child = p_x->left() != p_nil_ ? p_x->left() : p_x->right();
+    const auto p_x_child = p_x->left() != nullptr ? p_x->left() : p_x->right();
 
-    if (p_x_parent->left() == p_x)
-      p_x_parent->left() = p_x_child;
-    else
-      p_x_parent->right() = p_x_child;
-
-    p_x_child->parent() = p_x_parent;
+    replace_child_(p_x_parent, p_x, p_x_child);
 
     delete_node_(p_x);
   }
@@ -482,15 +488,32 @@ protected:
   {
     assert(p_nil_ != nullptr);
 
-    auto it = begin_postorder_depth_first_search(root());
-    auto it_end = end_postorder_depth_first_search(nil());
-
-    while (it != it_end)
-    {
-      delete_node_((it++).base().p_node_);
-    }
+    destroy_subtree_parallel_(p_nil_->right(), threads_for_(size_));
 
+    size_ = 0;
     p_nil_->right() = p_nil_;
+
+    release_free_slabs_(node_allocator_, 0);
+  }
+
+  const parallel_policy& get_parallel_policy() const
+  {
+    return parallel_policy_;
+  }
+
+  void set_parallel_policy(const parallel_policy& policy)
+  {
+    parallel_policy_ = policy;
+  }
+
+  // Builds a perfectly balanced tree of `n` elements taken from `from`, in
+  // order. The tree must be empty.
+  template <typename ForwardIterator>
+  void build(ForwardIterator from, size_type n)
+  {
+    assert(empty());
+
+    set_root_(build_subtree_(from, n));
   }
 
   void swap(binary& other)
@@ -507,13 +530,8 @@ protected:
 
   size_type max_size() const
   {
-    using node_allocator_type =
-      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
-
-    node_allocator_type node_allocator(*this);
-
     return std::min<size_type>(
-      std::allocator_traits<node_allocator_type>::max_size(node_allocator),
+      node_traits::max_size(node_allocator_),
       std::numeric_limits<difference_type>::max());
   }
 
@@ -524,6 +542,8 @@ protected:
 
   static typename ref_or_void<M>::type metadata(const_tree_iterator position)
   {
+    assert(position.p_node_ != nullptr);
+
     return position.p_node_->data.second();
   }
 
@@ -548,19 +568,21 @@ protected:
   // $   b   c    a   b   $
   tree_iterator rotate_left(const_tree_iterator x)
   {
-    assert(right(x) != nil());
+    assert(!!right(x));
 
     const auto p_x = x.p_node_;
     const auto p_y = p_x->right();
 
     p_x->right() = p_y->left();
-    p_y->left()->parent() = p_x;
+
+    if (p_y->left() != nullptr)
+      p_y->left()->parent() = p_x;
 
     p_y->parent() = p_x->parent();
 
     if (p_x == p_x->parent()->left())
       p_x->parent()->left() = p_y;
-    else
+    else if (p_x == p_x->parent()->right())
       p_x->parent()->right() = p_y;
 
     p_y->left() = p_x;
@@ -577,19 +599,21 @@ protected:
   // $ a   b        b   c $
   tree_iterator rotate_right(const_tree_iterator x)
   {
-    assert(left(x) != nil());
+    assert(!!left(x));
 
     const auto p_x = x.p_node_;
     const auto p_y = p_x->left();
 
     p_x->left() = p_y->right();
-    p_y->right()->parent() = p_x;
+
+    if (p_y->right() != nullptr)
+      p_y->right()->parent() = p_x;
 
     p_y->parent() = p_x->parent();
 
     if (p_x == p_x->parent()->right())
       p_x->parent()->right() = p_y;
-    else
+    else if (p_x == p_x->parent()->left())
       p_x->parent()->left() = p_y;
 
     p_y->right() = p_x;
@@ -598,24 +622,138 @@ protected:
     return tree_iterator(p_y);
   }
 
-private:
-  node_pointer new_nil_node_()
+  // Attaches the detached subtree `x` as the left child of `position`, or makes
+  // it the root if `position` is nil.
+  void link_left(const_tree_iterator position, const_tree_iterator x)
+  {
+    if (!position)
+    {
+      assert(!root());
+
+      set_root_(node_or_null_(x));
+
+      return;
+    }
+
+    assert(!left(position));
+
+    position.p_node_->left() = node_or_null_(x);
+
+    if (!!x)
+      x.p_node_->parent() = position.p_node_;
+  }
+
+  // Attaches the detached subtree `x` as the right child of `position`, or
+  // makes it the root if `position` is nil.
+  void link_right(const_tree_iterator position, const_tree_iterator x)
+  {
+    if (!position)
+    {
+      assert(!root());
+
+      set_root_(node_or_null_(x));
+
+      return;
+    }
+
+    assert(!right(position));
+
+    position.p_node_->right() = node_or_null_(x);
+
+    if (!!x)
+      x.p_node_->parent() = position.p_node_;
+  }
+
+  // Detaches the subtree `x` from its parent. The subtree stays owned by the
+  // container, its root's parent is nil.
+  void unlink(const_tree_iterator x)
+  {
+    assert(!!x);
+
+    const auto p_x = x.p_node_;
+    const auto p_parent = p_x->parent();
+
+    if (p_parent == p_nil_)
+    {
+      if (p_nil_->right() == p_x)
+        p_nil_->right() = p_nil_;
+    }
+    else if (p_parent->left() == p_x)
+    {
+      p_parent->left() = nullptr;
+    }
+    else
+    {
+      assert(p_parent->right() == p_x);
+
+      p_parent->right() = nullptr;
+    }
+
+    p_x->parent() = p_nil_;
+  }
+
+  // Moves the detached subtree `x` of `n` elements from `other` to this
+  // container, where it stays detached. The allocators must compare equal.
+  void adopt(binary& other, const_tree_iterator x, size_type n)
   {
-    using node_allocator_type =
-      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+    assert(get_allocator() == other.get_allocator());
+
+    if (!x)
+      return;
+
+    assert(x.p_node_->parent() == other.p_nil_);
+
+    x.p_node_->parent() = p_nil_;
+
+    other.size_ -= n;
+    size_ += n;
+  }
+
+  // Destroys the detached subtree `x` in time linear in its size
+  void erase_detached(const_tree_iterator x)
+  {
+    if (!x)
+      return;
+
+    assert(x.p_node_->parent() == p_nil_ && p_nil_->right() != x.p_node_);
+
+    size_ -= destroy_subtree_(x.p_node_);
+  }
+
+  // Whether `subtree_size` takes O(1) time; `Indexing` says so
+  static constexpr bool keeps_subtree_sizes = false;
+
+  static size_type subtree_size(const_tree_iterator x)
+  {
+    size_type n = 0;
+
+    if (!x)
+      return n;
+
+    for (auto it = begin_postorder_depth_first_search(x);; ++it)
+    {
+      ++n;
 
-    node_allocator_type node_allocator(*this);
+      if (it.base() == x)
+        break;
+    }
 
-    const auto p_nil = node_allocator.allocate(1);
+    return n;
+  }
+
+private:
+  node_pointer new_nil_node_()
+  {
+    const auto p_nil = node_traits::allocate(node_allocator_, 1);
 
     try
     {
       memory::construct(
-        get_allocator(), p_nil->data, links{nullptr, p_nil, p_nil});
+        node_allocator_, p_nil->data, links{nullptr, p_nil, p_nil});
     }
     catch (...)
     {
-      node_allocator.deallocate(p_nil, 1);
+      node_traits::deallocate(node_allocator_, p_nil, 1);
 
       throw;
     }
@@ -625,35 +763,25 @@ private:
 
   void delete_nil_node_(node_pointer p_node, std::true_type) noexcept
   {
-    using node_allocator_type =
-      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
-
-    node_allocator_type node_allocator(get_allocator());
+    memory::destroy(node_allocator_, p_nil_->data);
 
-    memory::destroy(get_allocator(), p_nil_->data);
-
-    node_allocator.deallocate(p_nil_, 1);
+    node_traits::deallocate(node_allocator_, p_nil_, 1);
   }
 
   void delete_nil_node_(node_pointer p_node, std::false_type) noexcept(false)
   {
-    using node_allocator_type =
-      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
-
-    node_allocator_type node_allocator(get_allocator());
-
     try
     {
-      memory::destroy(get_allocator(), p_nil_->data);
+      memory::destroy(node_allocator_, p_nil_->data);
     }
     catch (...)
     {
-      node_allocator.deallocate(p_nil_, 1);
+      node_traits::deallocate(node_allocator_, p_nil_, 1);
 
       throw;
     }
 
-    node_allocator.deallocate(p_nil_, 1);
+    node_traits::deallocate(node_allocator_, p_nil_, 1);
   }
 
   template <typename... Args>
@@ -662,8 +790,8 @@ private:
                          node_pointer p_right,
                          Args&&... args)
   {
-    const auto p_new_node = memory::new_object<node>(
-      get_allocator(), p_parent, p_left, p_right, std::forward<Args>(args)...);
+    const auto p_new_node =
+      create_node_(p_parent, p_left, p_right, std::forward<Args>(args)...);
 
     ++size_;
 
@@ -674,7 +802,222 @@ private:
   {
     --size_;
 
-    memory::delete_object<node>(get_allocator(), p_node);
+    destroy_node_(p_node);
+  }
+
+  // Same as `new_node_` and `delete_node_`, but leave `size_` alone, so that
+  // several threads may call them at once
+  template <typename... Args>
+  node_pointer create_node_(node_pointer p_parent,
+                            node_pointer p_left,
+                            node_pointer p_right,
+                            Args&&... args)
+  {
+    const auto p_node = node_traits::allocate(node_allocator_, 1);
+
+    try
+    {
+      node_traits::construct(node_allocator_,
+                             std::addressof(*p_node),
+                             p_parent,
+                             p_left,
+                             p_right,
+                             std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      node_traits::deallocate(node_allocator_, p_node, 1);
+
+      throw;
+    }
+
+    return p_node;
+  }
+
+  void destroy_node_(node_pointer p_node)
+  {
+    try
+    {
+      node_traits::destroy(node_allocator_, std::addressof(*p_node));
+    }
+    catch (...)
+    {
+      node_traits::deallocate(node_allocator_, p_node, 1);
+
+      throw;
+    }
+
+    node_traits::deallocate(node_allocator_, p_node, 1);
+  }
+
+  static node_pointer node_or_null_(const_tree_iterator x)
+  {
+    return !x ? node_pointer() : x.p_node_;
+  }
+
+  void set_root_(node_pointer p_root)
+  {
+    if (p_root == nullptr)
+    {
+      p_nil_->right() = p_nil_;
+
+      return;
+    }
+
+    p_nil_->right() = p_root;
+    p_root->parent() = p_nil_;
+  }
+
+  void replace_child_(node_pointer p_parent,
+                      node_pointer p_child,
+                      node_pointer p_new_child)
+  {
+    if (p_parent->left() == p_child)
+      p_parent->left() = p_new_child;
+    else if (p_parent == p_nil_ && p_new_child == nullptr)
+      p_parent->right() = p_nil_;
+    else
+      p_parent->right() = p_new_child;
+
+    if (p_new_child != nullptr)
+      p_new_child->parent() = p_parent;
+  }
+
+  // Lets an allocator which keeps freed nodes for reuse, like
+  // `pool_allocator`, return them upstream once the tree is cleared
+  template <typename A>
+  static auto release_free_slabs_(A& allocator, int)
+    -> decltype(allocator.release_free_slabs(), void())
+  {
+    allocator.release_free_slabs();
+  }
+
+  template <typename A> static void release_free_slabs_(A&, long)
+  {
+  }
+
+  // Number of threads to copy or clear `n` elements with. Allocators that are
+  // not thread safe, like `pool_allocator`, keep the tree sequential whatever
+  // its policy says.
+  unsigned threads_for_(size_type n) const
+  {
+    return is_thread_safe_allocator<allocator_type>::value
+             ? parallel_policy_.threads_for(n)
+             : 1;
+  }
+
+  void delete_subtree_(node_pointer p_node)
+  {
+    size_ -= destroy_subtree_(p_node);
+  }
+
+  // Destroys the subtree `p_root` in postorder without touching `size_` and
+  // without leaving it, so that the parent of `p_root` may be destroyed by
+  // another thread afterwards. Returns the number of destroyed nodes.
+  size_type destroy_subtree_(node_pointer p_root)
+  {
+    if (!tree_iterator(p_root))
+      return 0;
+
+    size_type n = 0;
+    auto p_node = first_in_postorder_(p_root);
+
+    while (p_node != p_root)
+    {
+      const auto p_parent = p_node->parent();
+      const auto p_next = p_parent->left() == p_node &&
+                              p_parent->right() != nullptr
+                            ? first_in_postorder_(p_parent->right())
+                            : p_parent;
+
+      destroy_node_(p_node);
+      ++n;
+
+      p_node = p_next;
+    }
+
+    destroy_node_(p_root);
+
+    return n + 1;
+  }
+
+  static node_pointer first_in_postorder_(node_pointer p_node)
+  {
+    while (true)
+    {
+      if (p_node->left() != nullptr)
+        p_node = p_node->left();
+      else if (p_node->right() != nullptr)
+        p_node = p_node->right();
+      else
+        return p_node;
+    }
+  }
+
+  // Destroys the subtree `p_root` on up to `threads` threads
+  size_type destroy_subtree_parallel_(node_pointer p_root, unsigned threads)
+  {
+    if (threads <= 1 || !tree_iterator(p_root))
+      return destroy_subtree_(p_root);
+
+    const auto p_left = p_root->left();
+    const auto p_right = p_root->right();
+
+    std::future<size_type> left_task;
+
+    try
+    {
+      left_task = std::async(std::launch::async, [this, p_left, threads]() {
+        return destroy_subtree_parallel_(p_left, threads / 2);
+      });
+    }
+    catch (const std::system_error&)
+    {
+      return destroy_subtree_(p_root);
+    }
+
+    const auto n =
+      destroy_subtree_parallel_(p_right, threads - threads / 2) +
+      left_task.get();
+
+    destroy_node_(p_root);
+
+    return n + 1;
+  }
+
+  template <typename ForwardIterator>
+  node_pointer build_subtree_(ForwardIterator& from, size_type n)
+  {
+    if (n == 0)
+      return nullptr;
+
+    const size_type left_size = (n - 1) / 2;
+
+    const auto p_left = build_subtree_(from, left_size);
+
+    node_pointer p_node = nullptr;
+
+    try
+    {
+      p_node = new_node_(p_nil_, p_left, nullptr, *from);
+      ++from;
+
+      if (p_left != nullptr)
+        p_left->parent() = p_node;
+
+      p_node->right() = build_subtree_(from, n - left_size - 1);
+
+      if (p_node->right() != nullptr)
+        p_node->right()->parent() = p_node;
+    }
+    catch (...)
+    {
+      delete_subtree_(p_node != nullptr ? p_node : p_left);
+
+      throw;
+    }
+
+    return p_node;
   }
 
   template <typename ConstBinaryTreeIterator>
@@ -682,7 +1025,7 @@ private:
                              node_pointer p_target_parent)
   {
     if (!x)
-      return p_nil_;
+      return nullptr;
 
     const auto p_node = new_node_(p_target_parent, nullptr, nullptr, *x);
 
@@ -692,36 +1035,155 @@ private:
     return p_node;
   }
 
+  // Copies the subtree `x` on up to `threads` threads. Leaves `size_` to the
+  // caller.
   node_pointer copy_subtree_(const_tree_iterator x,
-                             node_pointer p_target_parent)
+                             node_pointer p_target_parent,
+                             unsigned threads)
   {
-    if (!x)
-      return p_nil_;
+    return clone_subtree_parallel_(
+      x,
+      p_target_parent,
+      [this](const_tree_iterator y, node_pointer p) {
+        const auto p_node = create_node_(p, nullptr, nullptr, *y);
 
-    const auto p_node = new_node_(p_target_parent, nullptr, nullptr, *x);
+        copy_metadata_(y.p_node_->data, p_node->data);
 
-    p_node->left() = copy_subtree_(left(x), p_node);
-    p_node->right() = copy_subtree_(right(x), p_node);
+        return p_node;
+      },
+      threads);
+  }
+
+  node_pointer move_subtree_(tree_iterator x,
+                             node_pointer p_target_parent,
+                             unsigned threads)
+  {
+    return clone_subtree_parallel_(
+      x,
+      p_target_parent,
+      [this](tree_iterator y, node_pointer p) {
+        const auto p_node = create_node_(p, nullptr, nullptr, std::move(*y));
 
-    copy_metadata_(x.p_node_->data, p_node->data);
+        copy_metadata_(y.p_node_->data, p_node->data);
+
+        return p_node;
+      },
+      threads);
+  }
+
+  // Clones the subtree `x` with `clone_subtree_`, handing the subtrees near
+  // its root to other threads, up to `threads` threads in total
+  template <typename BinaryTreeIterator, typename Clone>
+  node_pointer clone_subtree_parallel_(BinaryTreeIterator x,
+                                       node_pointer p_target_parent,
+                                       const Clone& clone,
+                                       unsigned threads)
+  {
+    if (threads <= 1 || !x)
+      return clone_subtree_(x, p_target_parent, clone);
+
+    const auto p_node = clone(x, p_target_parent);
+
+    std::future<node_pointer> left_task;
+
+    try
+    {
+      left_task = std::async(std::launch::async, [&]() {
+        return clone_subtree_parallel_(left(x), p_node, clone, threads / 2);
+      });
+    }
+    catch (const std::system_error&)
+    {
+      destroy_node_(p_node);
+
+      return clone_subtree_(x, p_target_parent, clone);
+    }
+
+    try
+    {
+      p_node->right() = clone_subtree_parallel_(
+        right(x), p_node, clone, threads - threads / 2);
+    }
+    catch (...)
+    {
+      try
+      {
+        p_node->left() = left_task.get();
+      }
+      catch (...)
+      {
+      }
+
+      destroy_subtree_(p_node);
+
+      throw;
+    }
+
+    try
+    {
+      p_node->left() = left_task.get();
+    }
+    catch (...)
+    {
+      destroy_subtree_(p_node);
+
+      throw;
+    }
 
     return p_node;
   }
 
-  node_pointer move_subtree_(tree_iterator x, node_pointer p_target_parent)
+  // Clones the subtree `x` node by node with `clone(y, p_parent)`, which must
+  // not touch `size_`. Walks the tree without recursion, so that deep trees do
+  // not exhaust the stack.
+  template <typename BinaryTreeIterator, typename Clone>
+  node_pointer clone_subtree_(BinaryTreeIterator x,
+                              node_pointer p_target_parent,
+                              const Clone& clone)
   {
     if (!x)
-      return p_nil_;
+      return nullptr;
 
-    const auto p_node =
-      new_node_(p_target_parent, nullptr, nullptr, std::move(*x));
+    const auto p_root = clone(x, p_target_parent);
 
-    p_node->left() = move_subtree_(left(x), p_node);
-    p_node->right() = move_subtree_(right(x), p_node);
+    try
+    {
+      auto y = x;
+      auto p_node = p_root;
+
+      while (true)
+      {
+        if (!!left(y) && p_node->left() == nullptr)
+        {
+          y = left(y);
+          p_node->left() = clone(y, p_node);
+          p_node = p_node->left();
+        }
+        else if (!!right(y) && p_node->right() == nullptr)
+        {
+          y = right(y);
+          p_node->right() = clone(y, p_node);
+          p_node = p_node->right();
+        }
+        else if (y != x)
+        {
+          y = parent(y);
+          p_node = p_node->parent();
+        }
+        else
+        {
+          break;
+        }
+      }
+    }
+    catch (...)
+    {
+      destroy_subtree_(p_root);
 
-    copy_metadata_(x.p_node_->data, p_node->data);
+      throw;
+    }
 
-    return p_node;
+    return p_root;
   }
 
   void copy_assignment_(const binary& other, std::true_type)
@@ -754,9 +1216,11 @@ private:
     allocator_type& b = other;
 
     std::swap(a, b);
+    std::swap(node_allocator_, other.node_allocator_);
 
     std::swap(p_nil_, other.p_nil_);
     std::swap(size_, other.size_);
+    std::swap(parallel_policy_, other.parallel_policy_);
   }
 
   void swap_(binary& other, std::false_type)
@@ -765,6 +1229,7 @@ private:
 
     std::swap(p_nil_, other.p_nil_);
     std::swap(size_, other.size_);
+    std::swap(parallel_policy_, other.parallel_policy_);
   }
 
   template <typename U, typename V>
@@ -792,8 +1257,12 @@ private:
   }
 
 public:
+  // The allocator rebound to nodes once, so that allocating a node does not
+  // copy and rebind the allocator
+  node_allocator_type node_allocator_;
   size_type size_;
   node_pointer p_nil_;
+  parallel_policy parallel_policy_;
 };
 
 } // mixin
@@ -6,10 +6,18 @@
 
 #pragma once
 
+#include <dst/binary_tree/algorithm.h>
 #include <dst/binary_tree/initializer_tree.h>
 #include <dst/binary_tree/mixin.h>
+#include <dst/iterator_facade.h>
 #include <dst/utility.h>
 
+#include <cassert>     // assert
+#include <iterator>    // std::iterator_traits, std::random_access_iterator_tag
+#include <memory>      // std::allocator_traits
+#include <type_traits> // std::enable_if, std::is_convertible
+#include <utility>     // std::declval, std::swap
+
 namespace dst
 {
 
@@ -24,10 +32,18 @@ template <typename T,
           typename Allocator,
           template <typename, typename, typename>
           class Base>
-class indexing : public Base<T, pair_or_single<std::size_t, M>, Allocator>
+class indexing
+: public Base<
+    T,
+    pair_or_single<typename std::allocator_traits<Allocator>::size_type, M>,
+    Allocator>
 {
 private:
-  using base = Base<T, pair_or_single<std::size_t, M>, Allocator>;
+  // Subtree sizes never exceed what the allocator can address, so compact
+  // allocators get compact ranks.
+  using rank_type = typename std::allocator_traits<Allocator>::size_type;
+
+  using base = Base<T, pair_or_single<rank_type, M>, Allocator>;
 
   static_assert(is_unbalanced_binary_tree<typename base::tree_category>::value,
                 "Base mixin must be unbalanced");
@@ -39,14 +55,99 @@ protected:
   using typename base::const_reference;
   using typename base::reference;
 
-  using typename base::const_iterator;
-  using typename base::iterator;
-
   using typename base::difference_type;
   using typename base::size_type;
 
   using allocator_type = typename base::allocator_type;
 
+private:
+  // Steps like the iterator of the base mixin, and jumps and measures
+  // distances in O(log n) using the subtree sizes.
+  template <typename BaseIterator>
+  class iterator_base
+  : public iterator_facade<
+      iterator_base<BaseIterator>,
+      std::random_access_iterator_tag,
+      typename std::iterator_traits<BaseIterator>::value_type>
+  {
+  private:
+    friend iterator_facade<
+      iterator_base<BaseIterator>,
+      std::random_access_iterator_tag,
+      typename std::iterator_traits<BaseIterator>::value_type>;
+
+    using binary_tree_iterator = decltype(std::declval<BaseIterator>().base());
+
+  public:
+    explicit iterator_base(BaseIterator position = BaseIterator())
+    : position_(position)
+    {
+    }
+
+    explicit iterator_base(binary_tree_iterator position)
+    : position_(position)
+    {
+    }
+
+    template <
+      typename OtherIterator,
+      typename = typename std::enable_if<
+        std::is_convertible<OtherIterator, BaseIterator>::value>::type>
+    iterator_base(const iterator_base<OtherIterator>& other)
+    : iterator_base(static_cast<BaseIterator>(other.position_))
+    {
+    }
+
+    binary_tree_iterator base() const
+    {
+      return position_.base();
+    }
+
+    friend bool operator==(const iterator_base& lhs, const iterator_base& rhs)
+    {
+      return lhs.position_ == rhs.position_;
+    }
+
+  private:
+    template <typename> friend class iterator_base;
+
+    typename iterator_base::reference value() const
+    {
+      return *position_;
+    }
+
+    void move_forward()
+    {
+      ++position_;
+    }
+
+    void move_back()
+    {
+      --position_;
+    }
+
+    void advance(difference_type n)
+    {
+      position_ = BaseIterator(seek(base(), n));
+    }
+
+    difference_type distance_to(const iterator_base& other) const
+    {
+      return static_cast<difference_type>(offset(other.base())) -
+             static_cast<difference_type>(offset(base()));
+    }
+
+  private:
+    BaseIterator position_;
+  };
+
+protected:
+  using iterator = iterator_base<typename base::iterator>;
+  using const_iterator = iterator_base<typename base::const_iterator>;
+
+protected:
+  static constexpr bool keeps_subtree_sizes = true;
+
 public:
   static std::size_t subtree_size(const_tree_iterator x)
   {
@@ -111,18 +212,7 @@ public:
 
   size_type index(const_tree_iterator position) const
   {
-    size_type index = subtree_size(left(position));
-
-    for (auto p = parent(position); !!p;
-         std::swap(position, p), p = parent(position))
-    {
-      if (right(p) == position)
-      {
-        index += subtree_size(left(p)) + 1;
-      }
-    }
-
-    return index;
+    return offset(position);
   }
 
   size_type index(const_iterator position) const
@@ -159,7 +249,7 @@ protected:
     {
       for (auto tit = it.base(); !!tit; ++tit)
       {
-        ++rank(tit);
+        ++rank_ref(tit);
       }
     }
   }
@@ -172,7 +262,7 @@ protected:
 
     for (auto it = new_it; !!it; ++it)
     {
-      ++rank(it);
+      ++rank_ref(it);
     }
 
     return new_it;
@@ -186,17 +276,32 @@ protected:
 
     for (auto it = new_it; !!it; ++it)
     {
-      ++rank(it);
+      ++rank_ref(it);
     }
 
     return new_it;
   }
 
+  template <typename ForwardIterator>
+  void build(ForwardIterator from, size_type n)
+  {
+    base::build(from, n);
+
+    const auto it_end = end_postorder_depth_first_search(base::nil());
+    for (auto it = begin_postorder_depth_first_search(base::root());
+         it != it_end;
+         ++it)
+    {
+      const auto x = it.base();
+      rank_ref(x) = rank(left(x)) + rank(right(x)) + 1;
+    }
+  }
+
   void erase(const_tree_iterator position, const_tree_iterator sub)
   {
     for (auto it = sub; !!it; ++it)
     {
-      --rank(it);
+      --rank_ref(it);
     }
 
     base::erase(position, sub);
@@ -206,12 +311,42 @@ protected:
   {
     for (auto it = position; !!it; ++it)
     {
-      --rank(it);
+      --rank_ref(it);
     }
 
     base::erase(position);
   }
 
+  void link_left(const_tree_iterator position, const_tree_iterator x)
+  {
+    base::link_left(position, x);
+
+    for (auto it = position; !!it; ++it)
+    {
+      rank_ref(it) += rank(x);
+    }
+  }
+
+  void link_right(const_tree_iterator position, const_tree_iterator x)
+  {
+    base::link_right(position, x);
+
+    for (auto it = position; !!it; ++it)
+    {
+      rank_ref(it) += rank(x);
+    }
+  }
+
+  void unlink(const_tree_iterator x)
+  {
+    for (auto it = parent(x); !!it; ++it)
+    {
+      rank_ref(it) -= rank(x);
+    }
+
+    base::unlink(x);
+  }
+
   // $   |            |   $
   // $   x            y'  $
   // $  / \          / \  $
@@ -226,8 +361,8 @@ protected:
 
     tree_iterator y = base::rotate_left(x);
 
-    rank(x) = rank_a + rank_b + 1;
-    rank(y) = rank(x) + rank_c + 1;
+    rank_ref(x) = rank_a + rank_b + 1;
+    rank_ref(y) = rank(x) + rank_c + 1;
 
     return y;
   }
@@ -246,8 +381,8 @@ protected:
 
     tree_iterator y = base::rotate_right(x);
 
-    rank(x) = rank_b + rank_c + 1;
-    rank(y) = rank_a + rank(x) + 1;
+    rank_ref(x) = rank_b + rank_c + 1;
+    rank_ref(y) = rank_a + rank(x) + 1;
 
     return y;
   }
@@ -257,11 +392,115 @@ protected:
     return base::metadata(x).second();
   }
 
+  iterator begin()
+  {
+    return iterator(base::begin());
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(base::begin());
+  }
+
+  iterator end()
+  {
+    return iterator(base::end());
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(base::end());
+  }
+
 private:
-  static std::size_t& rank(const_tree_iterator x)
+  // Zero for null positions
+  static rank_type rank(const_tree_iterator x)
   {
+    return !x ? 0 : base::metadata(x).first();
+  }
+
+  static rank_type& rank_ref(const_tree_iterator x)
+  {
+    assert(!!x);
+
     return base::metadata(x).first();
   }
+
+  // In-order index of `position`, the size of the tree for nil.
+  static size_type offset(const_tree_iterator position)
+  {
+    if (!position)
+      return subtree_size(base::root_from_nil(position));
+
+    size_type index = subtree_size(left(position));
+
+    for (auto p = parent(position); !!p;
+         std::swap(position, p), p = parent(position))
+    {
+      if (right(p) == position)
+      {
+        index += subtree_size(left(p)) + 1;
+      }
+    }
+
+    return index;
+  }
+
+  // The node `n` positions away from `x`. Climbs only as far as the subtree
+  // containing the target, then descends to it.
+  template <typename BinaryTreeIterator>
+  static BinaryTreeIterator seek(BinaryTreeIterator x, difference_type n)
+  {
+    if (n == 0)
+      return x;
+
+    difference_type i = n;
+
+    if (!x)
+    {
+      x = base::root_from_nil(x);
+      i += static_cast<difference_type>(subtree_size(x));
+
+      assert(i >= 0 && i < static_cast<difference_type>(subtree_size(x)));
+    }
+    else
+    {
+      i += static_cast<difference_type>(subtree_size(left(x)));
+    }
+
+    while (i < 0 || i >= static_cast<difference_type>(subtree_size(x)))
+    {
+      const auto p = parent(x);
+
+      if (!p)
+      {
+        assert(i == static_cast<difference_type>(subtree_size(x)));
+
+        return p;
+      }
+
+      if (right(p) == x)
+        i += static_cast<difference_type>(subtree_size(left(p))) + 1;
+
+      x = p;
+    }
+
+    for (auto l = static_cast<difference_type>(subtree_size(left(x))); i != l;
+         l = static_cast<difference_type>(subtree_size(left(x))))
+    {
+      if (i < l)
+      {
+        x = left(x);
+      }
+      else
+      {
+        i -= l + 1;
+        x = right(x);
+      }
+    }
+
+    return x;
+  }
 };
 
 } // mixin
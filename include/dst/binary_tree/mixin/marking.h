@@ -10,6 +10,13 @@
 #include <dst/binary_tree/mixin.h>
 #include <dst/utility.h>
 
+#include <algorithm> // std::reverse
+#include <cassert>   // assert
+#include <cstddef>   // std::ptrdiff_t, std::size_t
+#include <memory>    // std::allocator_traits
+#include <utility>   // std::make_pair, std::pair
+#include <vector>
+
 namespace dst
 {
 
@@ -47,12 +54,20 @@ protected:
 public:
   void mark(undefined&);
 
+  void mark_range(undefined&);
+
   void unmark(undefined&);
 
+  void unmark_range(undefined&);
+
   void marked(undefined&);
 
   void marked_nodes(undefined&);
 
+  void marked_at(undefined&);
+
+  void marked_index(undefined&);
+
   void begin_marked(undefined&);
 
   void end_marked(undefined&);
@@ -106,11 +121,15 @@ public:
   using base::begin_marked;
   using base::end_marked;
   using base::mark;
+  using base::mark_range;
   using base::marked;
+  using base::marked_at;
+  using base::marked_index;
   using base::marked_nodes;
   using base::rbegin_marked;
   using base::rend_marked;
   using base::unmark;
+  using base::unmark_range;
 
 protected:
   explicit marking_base(const allocator_type& allocator)
@@ -295,11 +314,15 @@ public:
   using base::begin_marked;
   using base::end_marked;
   using base::mark;
+  using base::mark_range;
   using base::marked;
+  using base::marked_at;
+  using base::marked_index;
   using base::marked_nodes;
   using base::rbegin_marked;
   using base::rend_marked;
   using base::unmark;
+  using base::unmark_range;
 
 public:
   bool mark(const_tree_iterator x, Flag f = Flag())
@@ -309,7 +332,7 @@ public:
 
     for (; !!x; ++x)
     {
-      ++rank(x);
+      ++rank_ref(x);
     }
 
     return true;
@@ -320,6 +343,26 @@ public:
     return mark(x.base(), f);
   }
 
+  // Marks the nodes in `[first, last)`, a range of iterators or tree
+  // iterators. If they come in order, every count above them is written
+  // once, and marking k nodes takes O(k log(n / k) + log n) time instead of
+  // O(k log n). This pays off for nodes close to each other; far apart nodes
+  // are marked as fast one by one. Returns the number of nodes that were not
+  // marked before.
+  template <typename InputIterator,
+            typename = enable_for_input_iterator<InputIterator>>
+  std::size_t mark(InputIterator first, InputIterator last, Flag = Flag())
+  {
+    return update_marks(first, last, true);
+  }
+
+  // Marks the elements in `[from, to)` in O(k + log n) time
+  std::size_t
+  mark_range(const_iterator from, const_iterator to, Flag = Flag())
+  {
+    return update_range(from, to, true);
+  }
+
   bool unmark(const_tree_iterator x, Flag f = Flag())
   {
     if (!marked(x, f))
@@ -327,7 +370,7 @@ public:
 
     for (; !!x; ++x)
     {
-      --rank(x);
+      --rank_ref(x);
     }
 
     return true;
@@ -338,6 +381,19 @@ public:
     return unmark(x.base(), f);
   }
 
+  template <typename InputIterator,
+            typename = enable_for_input_iterator<InputIterator>>
+  std::size_t unmark(InputIterator first, InputIterator last, Flag = Flag())
+  {
+    return update_marks(first, last, false);
+  }
+
+  std::size_t
+  unmark_range(const_iterator from, const_iterator to, Flag = Flag())
+  {
+    return update_range(from, to, false);
+  }
+
   static bool marked(const_tree_iterator x, Flag = Flag())
   {
     assert(rank(left(x)) + rank(right(x)) <= rank(x));
@@ -353,7 +409,53 @@ public:
 
   static std::size_t marked_nodes(const_tree_iterator x, Flag = Flag())
   {
-    return base::metadata(x).first();
+    return rank(x);
+  }
+
+  // The marked node with `k` marked nodes before it, in O(log n) time.
+  // Returns `end_marked()` for `k` equal to the number of marked nodes.
+  marked_iterator marked_at(std::size_t k, Flag f = Flag())
+  {
+    if (k == rank(base::root()))
+      return end_marked(f);
+
+    return marked_iterator(marked_element(base::root(), k));
+  }
+
+  const_marked_iterator marked_at(std::size_t k, Flag f = Flag()) const
+  {
+    if (k == rank(base::root()))
+      return end_marked(f);
+
+    return const_marked_iterator(marked_element(base::root(), k));
+  }
+
+  // Number of marked nodes before `x`, in O(log n) time. For the end
+  // iterator this is the number of all marked nodes.
+  std::size_t marked_index(const_tree_iterator x, Flag = Flag()) const
+  {
+    if (!x)
+      return rank(base::root());
+
+    std::size_t index = rank(left(x));
+
+    for (auto p = parent(x); !!p; x = p, p = parent(x))
+    {
+      if (right(p) == x)
+        index += rank(p) - rank(x);
+    }
+
+    return index;
+  }
+
+  std::size_t marked_index(const_iterator x, Flag f = Flag()) const
+  {
+    return marked_index(x.base(), f);
+  }
+
+  std::size_t marked_index(const_marked_iterator x, Flag f = Flag()) const
+  {
+    return marked_index(x.base(), f);
   }
 
   marked_iterator begin_marked(Flag f = Flag())
@@ -431,13 +533,13 @@ public:
     {
       if (rank(right(x)) > 0)
         x = right(x);
-      else if (rank(left(x)) > 0)
+      else if (rank(left(x)) == rank(x))
         x = left(x);
       else
         break;
     }
 
-    assert(!!x && rank(x) == 1);
+    assert(!!x && marked(x, Flag()));
 
     return x;
   }
@@ -493,6 +595,36 @@ protected:
     base::erase(position);
   }
 
+  void link_left(const_tree_iterator position, const_tree_iterator x)
+  {
+    base::link_left(position, x);
+
+    for (auto it = position; !!it; ++it)
+    {
+      rank_ref(it) += rank(x);
+    }
+  }
+
+  void link_right(const_tree_iterator position, const_tree_iterator x)
+  {
+    base::link_right(position, x);
+
+    for (auto it = position; !!it; ++it)
+    {
+      rank_ref(it) += rank(x);
+    }
+  }
+
+  void unlink(const_tree_iterator x)
+  {
+    for (auto it = parent(x); !!it; ++it)
+    {
+      rank_ref(it) -= rank(x);
+    }
+
+    base::unlink(x);
+  }
+
   // $   |            |   $
   // $   x            y'  $
   // $  / \          / \  $
@@ -506,8 +638,8 @@ protected:
 
     tree_iterator y = base::rotate_left(x);
 
-    rank(x) = rank(left(x)) + rank(right(x)) + x_marked;
-    rank(y) = rank(left(y)) + rank(right(y)) + y_marked;
+    rank_ref(x) = rank(left(x)) + rank(right(x)) + x_marked;
+    rank_ref(y) = rank(left(y)) + rank(right(y)) + y_marked;
 
     return y;
   }
@@ -525,8 +657,8 @@ protected:
 
     tree_iterator y = base::rotate_right(x);
 
-    rank(x) = rank(left(x)) + rank(right(x)) + x_marked;
-    rank(y) = rank(left(y)) + rank(right(y)) + y_marked;
+    rank_ref(x) = rank(left(x)) + rank(right(x)) + x_marked;
+    rank_ref(y) = rank(left(y)) + rank(right(y)) + y_marked;
 
     return y;
   }
@@ -537,10 +669,170 @@ protected:
   }
 
 private:
-  static std::size_t& rank(const_tree_iterator x)
+  // Zero for null positions
+  static std::size_t rank(const_tree_iterator x)
+  {
+    return !x ? 0 : base::metadata(x).first();
+  }
+
+  static std::size_t& rank_ref(const_tree_iterator x)
   {
+    assert(!!x);
+
     return base::metadata(x).first();
   }
+
+  // The marked node of the subtree `x` with `k` marked nodes before it
+  template <typename BinaryTreeIterator>
+  static BinaryTreeIterator marked_element(BinaryTreeIterator x, std::size_t k)
+  {
+    assert(rank(x) > k);
+
+    while (k != rank(left(x)) || !marked(x, Flag()))
+    {
+      if (k < rank(left(x)))
+      {
+        x = left(x);
+      }
+      else
+      {
+        k -= rank(x) - rank(right(x));
+        x = right(x);
+      }
+    }
+
+    return x;
+  }
+
+  static const_tree_iterator tree_position(const_tree_iterator x)
+  {
+    return x;
+  }
+
+  static const_tree_iterator tree_position(const_iterator x)
+  {
+    return x.base();
+  }
+
+  // Marks or unmarks nodes, deferring the updates of the counts above them.
+  // Keeps the path from the root to the last node with the pending change of
+  // every count on it. A node which is not below the path pops the path up
+  // to its lowest ancestor on it, adding the popped changes to the counts, and
+  // extends the path down to itself. The nodes on the path borrow the highest
+  // bit of their counts, which never get that large.
+  class deferred_update
+  {
+  public:
+    deferred_update(bool value, const allocator_type& allocator)
+    : value_(value)
+    , path_(path_allocator_type(allocator))
+    {
+    }
+
+    deferred_update(const deferred_update&) = delete;
+    deferred_update& operator=(const deferred_update&) = delete;
+
+    ~deferred_update()
+    {
+      flush(const_tree_iterator());
+    }
+
+    // Returns `false` if `x` already has the mark
+    bool update(const_tree_iterator x)
+    {
+      assert(!!x);
+
+      auto y = x;
+      std::size_t n = 0;
+
+      while (!!y && (rank(y) & on_path_bit) == 0)
+      {
+        ++y;
+        ++n;
+      }
+
+      flush(y);
+
+      // A node may borrow the bit only once its entry is sure to fit
+      path_.reserve(path_.size() + n);
+
+      const auto from = path_.size();
+
+      for (auto z = x; z != y; ++z)
+      {
+        rank_ref(z) |= on_path_bit;
+        path_.push_back(std::make_pair(z, std::ptrdiff_t(0)));
+      }
+
+      std::reverse(path_.begin() + from, path_.end());
+
+      auto& delta = path_.back().second;
+
+      const bool marked = (rank(x) & ~on_path_bit) + delta >
+                          rank(left(x)) + rank(right(x));
+
+      if (marked == value_)
+        return false;
+
+      delta += value_ ? 1 : -1;
+
+      return true;
+    }
+
+  private:
+    using path_node = std::pair<const_tree_iterator, std::ptrdiff_t>;
+
+    using path_allocator_type = typename std::allocator_traits<
+      allocator_type>::template rebind_alloc<path_node>;
+
+    static constexpr std::size_t on_path_bit = ~(~std::size_t(0) >> 1);
+
+    // Pops the path up to `x`, or entirely if `x` is nil
+    void flush(const_tree_iterator x)
+    {
+      while (!path_.empty() && path_.back().first != x)
+      {
+        const auto node = path_.back();
+
+        path_.pop_back();
+
+        rank_ref(node.first) = (rank(node.first) & ~on_path_bit) + node.second;
+
+        if (!path_.empty())
+          path_.back().second += node.second;
+      }
+    }
+
+    bool value_;
+    std::vector<path_node, path_allocator_type> path_;
+  };
+
+  template <typename InputIterator>
+  std::size_t update_marks(InputIterator first, InputIterator last, bool value)
+  {
+    deferred_update u(value, base::get_allocator());
+    std::size_t n = 0;
+
+    for (; first != last; ++first)
+    {
+      n += u.update(tree_position(*first));
+    }
+
+    return n;
+  }
+
+  std::size_t update_range(const_iterator from, const_iterator to, bool value)
+  {
+    deferred_update u(value, base::get_allocator());
+    std::size_t n = 0;
+
+    for (; from != to; ++from)
+    {
+      n += u.update(from.base());
+    }
+
+    return n;
+  }
 };
 
 } // mixin
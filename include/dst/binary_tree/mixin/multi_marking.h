@@ -0,0 +1,649 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/initializer_tree.h>
+#include <dst/binary_tree/mixin.h>
+#include <dst/iterator_facade.h>
+#include <dst/utility.h>
+
+#include <algorithm> // std::min
+#include <array>
+#include <cassert> // assert
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+#include <limits>  // std::numeric_limits
+#include <tuple>
+#include <type_traits>
+#include <utility> // std::move
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+namespace mixin
+{
+
+namespace detail
+{
+
+template <typename Flag, typename... Flags> struct flag_index;
+
+template <typename Flag, typename... Flags>
+struct flag_index<Flag, Flag, Flags...>
+: std::integral_constant<std::size_t, 0>
+{
+};
+
+template <typename Flag, typename Other, typename... Flags>
+struct flag_index<Flag, Other, Flags...>
+: std::integral_constant<std::size_t, 1 + flag_index<Flag, Flags...>::value>
+{
+};
+
+} // detail
+
+// Same as stacking `Marking<Flags>...`, but the counts of all flags are kept
+// together in counters of type `Count`, so that every flag adds
+// `sizeof(Count)` bytes to a node. The tree may hold no more elements than
+// `Count` can count.
+template <typename Count,
+          typename FlagList,
+          typename T,
+          typename M,
+          typename Allocator,
+          template <typename, typename, typename>
+          class Base>
+class multi_marking;
+
+template <typename Count,
+          typename... Flags,
+          typename T,
+          typename M,
+          typename Allocator,
+          template <typename, typename, typename>
+          class Base>
+class multi_marking<Count, std::tuple<Flags...>, T, M, Allocator, Base>
+: public Base<T,
+                pair_or_single<std::array<Count, sizeof...(Flags)>, M>,
+                Allocator>
+{
+private:
+  static_assert(std::is_unsigned<Count>::value, "Count must be unsigned");
+  static_assert(sizeof...(Flags) > 0, "At least one flag is required");
+
+  static constexpr std::size_t flags = sizeof...(Flags);
+
+  using counts = std::array<Count, flags>;
+
+  using base = Base<T, pair_or_single<counts, M>, Allocator>;
+
+  template <typename Flag>
+  using index = detail::flag_index<Flag, Flags...>;
+
+  template <typename BinaryTreeIterator, std::size_t I>
+  class marked_iterator_base
+  : public iterator_facade<
+      marked_iterator_base<BinaryTreeIterator, I>,
+      std::bidirectional_iterator_tag,
+      typename std::iterator_traits<BinaryTreeIterator>::value_type>
+  {
+  private:
+    friend iterator_facade<
+      marked_iterator_base<BinaryTreeIterator, I>,
+      std::bidirectional_iterator_tag,
+      typename std::iterator_traits<BinaryTreeIterator>::value_type>;
+
+  public:
+    explicit marked_iterator_base(
+      BinaryTreeIterator position = BinaryTreeIterator())
+    : position_(position)
+    {
+    }
+
+    template <
+      typename OtherIterator,
+      typename = typename std::enable_if<
+        std::is_convertible<OtherIterator, BinaryTreeIterator>::value>::type>
+    marked_iterator_base(const marked_iterator_base<OtherIterator, I>& other)
+    : marked_iterator_base(static_cast<BinaryTreeIterator>(other.base()))
+    {
+    }
+
+    BinaryTreeIterator base() const
+    {
+      return position_;
+    }
+
+    friend bool operator==(const marked_iterator_base& lhs,
+                           const marked_iterator_base& rhs)
+    {
+      return lhs.position_ == rhs.position_;
+    }
+
+  private:
+    typename marked_iterator_base::reference value() const
+    {
+      return *position_;
+    }
+
+    void move_forward()
+    {
+      assert(!!position_);
+
+      auto position = position_;
+
+      if (rank(right(position), I) > 0)
+      {
+        position_ = marked_minimum(right(position), I);
+      }
+      else
+      {
+        auto p = parent(position);
+
+        while (!!p && (position == right(p) ||
+                       rank(position, I) == rank(p, I)))
+        {
+          position = p;
+          p = parent(p);
+        }
+
+        if (!p || marked_flag(p, I))
+          position_ = p;
+        else
+          position_ = marked_minimum(right(p), I);
+      }
+    }
+
+    void move_back()
+    {
+      if (!position_)
+      {
+        position_ = marked_maximum(base::root_from_nil(position_), I);
+
+        return;
+      }
+
+      auto position = position_;
+
+      if (rank(left(position), I) > 0)
+      {
+        position_ = marked_maximum(left(position), I);
+      }
+      else
+      {
+        auto p = parent(position);
+
+        while (!!p && (position == left(p) ||
+                       rank(position, I) == rank(p, I)))
+        {
+          position = p;
+          p = parent(p);
+        }
+
+        if (!p || marked_flag(p, I))
+          position_ = p;
+        else
+          position_ = marked_maximum(left(p), I);
+      }
+    }
+
+  private:
+    BinaryTreeIterator position_;
+  };
+
+protected:
+  using tree_category = unbalanced_binary_tree_tag;
+
+  using typename base::const_iterator;
+  using typename base::const_tree_iterator;
+  using typename base::iterator;
+  using typename base::tree_iterator;
+
+  using typename base::size_type;
+
+  using allocator_type = typename base::allocator_type;
+
+  template <typename Flag>
+  using marked_iterator =
+    marked_iterator_base<tree_iterator, index<Flag>::value>;
+
+  template <typename Flag>
+  using const_marked_iterator =
+    marked_iterator_base<const_tree_iterator, index<Flag>::value>;
+
+public:
+  template <typename Flag> bool mark(const_tree_iterator x, Flag = Flag())
+  {
+    return mark_flag(x, index<Flag>::value);
+  }
+
+  template <typename Flag> bool mark(const_iterator x, Flag f = Flag())
+  {
+    return mark(x.base(), f);
+  }
+
+  template <typename Flag> bool unmark(const_tree_iterator x, Flag = Flag())
+  {
+    return unmark_flag(x, index<Flag>::value);
+  }
+
+  template <typename Flag> bool unmark(const_iterator x, Flag f = Flag())
+  {
+    return unmark(x.base(), f);
+  }
+
+  template <typename Flag>
+  static bool marked(const_tree_iterator x, Flag = Flag())
+  {
+    return marked_flag(x, index<Flag>::value);
+  }
+
+  template <typename Flag>
+  static bool marked(const_iterator x, Flag f = Flag())
+  {
+    return marked(x.base(), f);
+  }
+
+  template <typename Flag>
+  static std::size_t marked_nodes(const_tree_iterator x, Flag = Flag())
+  {
+    return rank(x, index<Flag>::value);
+  }
+
+  template <typename Flag>
+  marked_iterator<Flag> marked_at(std::size_t k, Flag f = Flag())
+  {
+    if (k == rank(base::root(), index<Flag>::value))
+      return end_marked(f);
+
+    return marked_iterator<Flag>(
+      marked_element(base::root(), k, index<Flag>::value));
+  }
+
+  template <typename Flag>
+  const_marked_iterator<Flag> marked_at(std::size_t k, Flag f = Flag()) const
+  {
+    if (k == rank(base::root(), index<Flag>::value))
+      return end_marked(f);
+
+    return const_marked_iterator<Flag>(
+      marked_element(base::root(), k, index<Flag>::value));
+  }
+
+  template <typename Flag>
+  std::size_t marked_index(const_tree_iterator x, Flag = Flag()) const
+  {
+    const auto i = index<Flag>::value;
+
+    if (!x)
+      return rank(base::root(), i);
+
+    std::size_t result = rank(left(x), i);
+
+    for (auto p = parent(x); !!p; x = p, p = parent(x))
+    {
+      if (right(p) == x)
+        result += rank(p, i) - rank(x, i);
+    }
+
+    return result;
+  }
+
+  template <typename Flag>
+  std::size_t marked_index(const_iterator x, Flag f = Flag()) const
+  {
+    return marked_index(x.base(), f);
+  }
+
+  template <typename Flag>
+  marked_iterator<Flag> begin_marked(Flag f = Flag())
+  {
+    if (rank(base::root(), index<Flag>::value) == 0)
+      return end_marked(f);
+
+    return marked_iterator<Flag>(
+      marked_minimum(base::root(), index<Flag>::value));
+  }
+
+  template <typename Flag>
+  const_marked_iterator<Flag> begin_marked(Flag f = Flag()) const
+  {
+    if (rank(base::root(), index<Flag>::value) == 0)
+      return end_marked(f);
+
+    return const_marked_iterator<Flag>(
+      marked_minimum(base::root(), index<Flag>::value));
+  }
+
+  template <typename Flag> marked_iterator<Flag> end_marked(Flag = Flag())
+  {
+    return marked_iterator<Flag>(base::end().base());
+  }
+
+  template <typename Flag>
+  const_marked_iterator<Flag> end_marked(Flag = Flag()) const
+  {
+    return const_marked_iterator<Flag>(base::end().base());
+  }
+
+  template <typename Flag>
+  std::reverse_iterator<marked_iterator<Flag>> rbegin_marked(Flag f = Flag())
+  {
+    return std::reverse_iterator<marked_iterator<Flag>>(end_marked(f));
+  }
+
+  template <typename Flag>
+  std::reverse_iterator<const_marked_iterator<Flag>>
+  rbegin_marked(Flag f = Flag()) const
+  {
+    return std::reverse_iterator<const_marked_iterator<Flag>>(end_marked(f));
+  }
+
+  template <typename Flag>
+  std::reverse_iterator<marked_iterator<Flag>> rend_marked(Flag f = Flag())
+  {
+    return std::reverse_iterator<marked_iterator<Flag>>(begin_marked(f));
+  }
+
+  template <typename Flag>
+  std::reverse_iterator<const_marked_iterator<Flag>>
+  rend_marked(Flag f = Flag()) const
+  {
+    return std::reverse_iterator<const_marked_iterator<Flag>>(begin_marked(f));
+  }
+
+  size_type max_size() const
+  {
+    return std::min<size_type>(base::max_size(),
+                               std::numeric_limits<Count>::max());
+  }
+
+protected:
+  multi_marking()
+  : base()
+  {
+  }
+
+  explicit multi_marking(const allocator_type& allocator)
+  : base(allocator)
+  {
+  }
+
+  explicit multi_marking(const multi_marking& other,
+                         const allocator_type& allocator)
+  : base(other, allocator)
+  {
+  }
+
+  multi_marking(multi_marking&& other, const allocator_type& allocator)
+  : base(std::move(other), allocator)
+  {
+  }
+
+  multi_marking(const initializer_tree<T>& init,
+                const allocator_type& allocator)
+  : base(init, allocator)
+  {
+  }
+
+  void erase(const_tree_iterator position, const_tree_iterator sub)
+  {
+    std::array<bool, flags> sub_marked;
+
+    for (std::size_t i = 0; i < flags; ++i)
+    {
+      unmark_flag(position, i);
+      sub_marked[i] = unmark_flag(sub, i);
+    }
+
+    base::erase(position, sub);
+
+    for (std::size_t i = 0; i < flags; ++i)
+    {
+      if (sub_marked[i])
+        mark_flag(sub, i);
+    }
+  }
+
+  void erase(const_tree_iterator position)
+  {
+    for (std::size_t i = 0; i < flags; ++i)
+    {
+      unmark_flag(position, i);
+    }
+
+    base::erase(position);
+  }
+
+  void link_left(const_tree_iterator position, const_tree_iterator x)
+  {
+    base::link_left(position, x);
+
+    add_to_path(position, subtree_counts(x), true);
+  }
+
+  void link_right(const_tree_iterator position, const_tree_iterator x)
+  {
+    base::link_right(position, x);
+
+    add_to_path(position, subtree_counts(x), true);
+  }
+
+  void unlink(const_tree_iterator x)
+  {
+    add_to_path(parent(x), subtree_counts(x), false);
+
+    base::unlink(x);
+  }
+
+  tree_iterator rotate_left(const_tree_iterator x)
+  {
+    const auto x_marked = own_marks(x);
+    const auto y_marked = own_marks(right(x));
+
+    tree_iterator y = base::rotate_left(x);
+
+    recount(x, x_marked);
+    recount(y, y_marked);
+
+    return y;
+  }
+
+  tree_iterator rotate_right(const_tree_iterator x)
+  {
+    const auto x_marked = own_marks(x);
+    const auto y_marked = own_marks(left(x));
+
+    tree_iterator y = base::rotate_right(x);
+
+    recount(x, x_marked);
+    recount(y, y_marked);
+
+    return y;
+  }
+
+  static typename ref_or_void<M>::type metadata(const_tree_iterator x)
+  {
+    return base::metadata(x).second();
+  }
+
+private:
+  // Zero for null positions
+  static Count rank(const_tree_iterator x, std::size_t i)
+  {
+    return !x ? 0 : base::metadata(x).first()[i];
+  }
+
+  static Count& rank_ref(const_tree_iterator x, std::size_t i)
+  {
+    assert(!!x);
+
+    return base::metadata(x).first()[i];
+  }
+
+  static counts subtree_counts(const_tree_iterator x)
+  {
+    return !x ? counts() : base::metadata(x).first();
+  }
+
+  static bool marked_flag(const_tree_iterator x, std::size_t i)
+  {
+    assert(rank(left(x), i) + rank(right(x), i) <= rank(x, i));
+    assert(rank(x, i) - (rank(left(x), i) + rank(right(x), i)) <= 1);
+
+    return rank(left(x), i) + rank(right(x), i) < rank(x, i);
+  }
+
+  bool mark_flag(const_tree_iterator x, std::size_t i)
+  {
+    if (marked_flag(x, i))
+      return false;
+
+    for (; !!x; ++x)
+    {
+      ++rank_ref(x, i);
+    }
+
+    return true;
+  }
+
+  bool unmark_flag(const_tree_iterator x, std::size_t i)
+  {
+    if (!marked_flag(x, i))
+      return false;
+
+    for (; !!x; ++x)
+    {
+      --rank_ref(x, i);
+    }
+
+    return true;
+  }
+
+  static std::array<bool, flags> own_marks(const_tree_iterator x)
+  {
+    std::array<bool, flags> result;
+
+    for (std::size_t i = 0; i < flags; ++i)
+    {
+      result[i] = marked_flag(x, i);
+    }
+
+    return result;
+  }
+
+  static void recount(const_tree_iterator x,
+                      const std::array<bool, flags>& own)
+  {
+    for (std::size_t i = 0; i < flags; ++i)
+    {
+      rank_ref(x, i) = rank(left(x), i) + rank(right(x), i) + own[i];
+    }
+  }
+
+  // Adds or subtracts `delta` to the counts of `x` and its ancestors
+  static void add_to_path(const_tree_iterator x, counts delta, bool add)
+  {
+    for (; !!x; ++x)
+    {
+      for (std::size_t i = 0; i < flags; ++i)
+      {
+        if (add)
+          rank_ref(x, i) += delta[i];
+        else
+          rank_ref(x, i) -= delta[i];
+      }
+    }
+  }
+
+  template <typename BinaryTreeIterator>
+  static BinaryTreeIterator
+  marked_element(BinaryTreeIterator x, std::size_t k, std::size_t i)
+  {
+    assert(rank(x, i) > k);
+
+    while (k != rank(left(x), i) || !marked_flag(x, i))
+    {
+      if (k < rank(left(x), i))
+      {
+        x = left(x);
+      }
+      else
+      {
+        k -= rank(x, i) - rank(right(x), i);
+        x = right(x);
+      }
+    }
+
+    return x;
+  }
+
+  template <typename BinaryTreeIterator>
+  static BinaryTreeIterator marked_minimum(BinaryTreeIterator x, std::size_t i)
+  {
+    assert(!!x && rank(x, i) > 0);
+
+    while (true)
+    {
+      if (rank(left(x), i) > 0)
+        x = left(x);
+      else if (rank(right(x), i) == rank(x, i))
+        x = right(x);
+      else
+        break;
+    }
+
+    assert(marked_flag(x, i));
+
+    return x;
+  }
+
+  template <typename BinaryTreeIterator>
+  static BinaryTreeIterator marked_maximum(BinaryTreeIterator x, std::size_t i)
+  {
+    assert(!!x && rank(x, i) > 0);
+
+    while (true)
+    {
+      if (rank(right(x), i) > 0)
+        x = right(x);
+      else if (rank(left(x), i) == rank(x, i))
+        x = left(x);
+      else
+        break;
+    }
+
+    assert(marked_flag(x, i));
+
+    return x;
+  }
+};
+
+} // mixin
+
+template <typename Count, typename... Flags> class BasicMultiMarking
+{
+public:
+  template <typename T,
+            typename M,
+            typename Allocator,
+            template <typename, typename, typename>
+            class Base>
+  using type =
+    mixin::multi_marking<Count, std::tuple<Flags...>, T, M, Allocator, Base>;
+};
+
+// Flags with 32-bit counts, for trees of up to 2^32 - 1 elements
+template <typename... Flags>
+using MultiMarking = BasicMultiMarking<std::uint32_t, Flags...>;
+
+} // binary_tree
+
+} // dst
@@ -6,13 +6,16 @@
 
 #pragma once
 
+#include <dst/binary_tree/algorithm.h>
 #include <dst/binary_tree/iterator_facade.h>
 #include <dst/binary_tree/mixin.h>
+#include <dst/utility.h>
 
-#include <memory> // std::allocator_traits, std::allocator
+#include <cassert> // assert
+#include <cstdint> // std::uint64_t
+#include <memory>  // std::allocator
 #include <type_traits>
-#include <utility> // std::move
-#include <vector>
+#include <utility> // std::forward, std::move
 
 namespace dst
 {
@@ -34,71 +37,15 @@ public:
   using binary_tree_iterator = BinaryTreeIterator;
 
 public:
-  ordering_algorithm(const allocator_type& allocator = allocator_type())
-  : x_to_root_path_(allocator)
-  , y_to_root_path_(allocator)
+  ordering_algorithm(const allocator_type& = allocator_type())
   {
   }
 
+  // Allocates nothing and keeps no state, so it may run concurrently
   bool order(binary_tree_iterator x, binary_tree_iterator y) const
   {
-    if (x == y)
-      return false;
-
-    if (!y)
-    {
-      assert(!!x);
-      return true;
-    }
-
-    if (!x)
-    {
-      assert(!!y);
-      return false;
-    }
-
-    x_to_root_path_.clear();
-    y_to_root_path_.clear();
-
-    for (; !!x; ++x)
-    {
-      x_to_root_path_.push_back(x);
-    }
-
-    for (; !!y; ++y)
-    {
-      y_to_root_path_.push_back(y);
-    }
-
-    assert(x_to_root_path_.back() == y_to_root_path_.back());
-
-    auto it_x = x_to_root_path_.crbegin();
-    auto it_y = y_to_root_path_.crbegin();
-
-    for (; it_x != x_to_root_path_.crend() && it_y != y_to_root_path_.crend();
-         ++it_x, ++it_y)
-    {
-      if (*it_x != *it_y)
-        return (left(parent(*it_x)) == *it_x);
-    }
-
-    if (it_x != x_to_root_path_.crend())
-    {
-      assert(it_y == y_to_root_path_.crend());
-      return (left(parent(*it_x)) == *it_x);
-    }
-
-    assert(it_x == x_to_root_path_.crend());
-    assert(it_y != y_to_root_path_.crend());
-
-    return (right(parent(*it_y)) == *it_y);
+    return dst::order(x, y);
   }
-
-private:
-  using path_container = std::vector<binary_tree_iterator, allocator_type>;
-
-  mutable path_container x_to_root_path_;
-  mutable path_container y_to_root_path_;
 };
 
 namespace mixin
@@ -126,7 +73,7 @@ protected:
 public:
   bool order(const_tree_iterator x, const_tree_iterator y) const
   {
-    return ordering_.order(x, y);
+    return dst::order(x, y);
   }
 
   bool order(const_iterator x, const_iterator y) const
@@ -137,33 +84,290 @@ public:
 protected:
   ordering()
   : base()
-  , ordering_(base::get_allocator())
   {
   }
 
   explicit ordering(const allocator_type& allocator)
   : base(allocator)
-  , ordering_(allocator)
   {
   }
 
   explicit ordering(const ordering& other, const allocator_type& allocator)
   : base(other, allocator)
-  , ordering_(allocator)
   {
   }
 
   ordering(ordering&& other, const allocator_type& allocator)
   : base(std::move(other), allocator)
-  , ordering_(allocator)
   {
   }
+};
+
+// Order maintenance: every node carries an integer label, and the labels
+// grow in the in-order sequence, so `order` compares two integers. It
+// allocates nothing and writes nothing, so any number of threads may call it
+// at once. An insertion takes the label halfway between the neighbours; when
+// there is no room, the smallest aligned label range around the new node that
+// is sparse enough gets relabeled evenly (Bender et al.'s variant of
+// Dietz-Sleator), which takes O(log n) amortized time.
+// Joining trees whose labels overlap relabels only the shorter of the two
+// overlapping runs, between its neighbours if there is room and the same way
+// as an insertion otherwise.
+template <typename T,
+          typename M,
+          typename Allocator,
+          template <typename, typename, typename>
+          class Base>
+class order_maintenance
+: public Base<T, pair_or_single<std::uint64_t, M>, Allocator>
+{
+private:
+  using base = Base<T, pair_or_single<std::uint64_t, M>, Allocator>;
+
+  static_assert(is_balanced_binary_tree<typename base::tree_category>::value,
+                "Order maintenance must be based on a balanced binary tree");
+
+  using label_type = std::uint64_t;
+
+  static constexpr unsigned label_bits = 62;
+  static constexpr label_type label_space = label_type(1) << label_bits;
+
+  // A range of 2^i labels may hold up to density^i nodes. The O(log n)
+  // amortized bound holds while the whole label range may hold the whole
+  // tree, that is up to density^62 nodes, about 8e10. Each node holds three
+  // links and a label, so such a tree would take terabytes. A smaller density
+  // relabels less at a time, but past density^62 nodes running out of labels
+  // in one spot relabels ranges holding a fixed share of the tree.
+  static constexpr double density = 1.5;
+
+protected:
+  using typename base::const_iterator;
+  using typename base::const_tree_iterator;
+  using typename base::tree_iterator;
+
+  using typename base::size_type;
+
+  using allocator_type = typename base::allocator_type;
+
+public:
+  static bool order(const_tree_iterator x, const_tree_iterator y)
+  {
+    if (!y)
+      return !!x;
+
+    if (!x)
+      return false;
+
+    return label(x) < label(y);
+  }
+
+  static bool order(const_iterator x, const_iterator y)
+  {
+    return order(x.base(), y.base());
+  }
+
+protected:
+  order_maintenance()
+  : base()
+  {
+  }
+
+  explicit order_maintenance(const allocator_type& allocator)
+  : base(allocator)
+  {
+  }
+
+  explicit order_maintenance(const order_maintenance& other,
+                             const allocator_type& allocator)
+  : base(other, allocator)
+  {
+  }
+
+  order_maintenance(order_maintenance&& other, const allocator_type& allocator)
+  : base(std::move(other), allocator)
+  {
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_left(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_left(position, std::forward<Args>(args)...);
+
+    after_insertion(x);
+
+    return x;
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_right(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_right(position, std::forward<Args>(args)...);
+
+    after_insertion(x);
+
+    return x;
+  }
+
+  template <typename ForwardIterator>
+  void build(ForwardIterator from, size_type n)
+  {
+    base::build(from, n);
+
+    relabel(base::root());
+  }
+
+  // Concatenates the detached trees `x` and `y`. Returns the root of the
+  // resulting detached tree. If the labels overlap, only the nodes of the
+  // shorter overlapping run get new labels, so splicing k nodes into a tree
+  // relabels O(k) nodes unless the gap between their neighbours is too narrow.
+  tree_iterator join(const_tree_iterator x, const_tree_iterator y)
+  {
+    if (!x || !y)
+      return base::join(x, y);
+
+    const auto x_last = maximum(x);
+    const auto y_first = minimum(y);
+    const auto root = base::join(x, y);
+
+    if (label(x_last) < label(y_first))
+      return root;
+
+    // Walks the run of `x` at and above the first label of `y` and the run of
+    // `y` at and below the last label of `x` in step until one of them ends
+    auto x_first = x_last;
+    auto y_last = y_first;
+
+    for (label_type count = 1;; ++count)
+    {
+      const auto p = predecessor(x_first);
+
+      if (!p || label(p) < label(y_first))
+      {
+        relabel_run(x_first, x_last, count);
+        break;
+      }
+
+      const auto s = successor(y_last);
+
+      if (!s || label(s) > label(x_last))
+      {
+        relabel_run(y_first, y_last, count);
+        break;
+      }
+
+      x_first = p;
+      y_last = s;
+    }
+
+    return root;
+  }
+
+  static typename ref_or_void<M>::type metadata(const_tree_iterator x)
+  {
+    return base::metadata(x).second();
+  }
 
 private:
-  ordering_algorithm<const_tree_iterator,
-                     typename std::allocator_traits<allocator_type>::
-                       template rebind_alloc<const_tree_iterator>>
-    ordering_;
+  static label_type& label(const_tree_iterator x)
+  {
+    assert(!!x);
+
+    return base::metadata(x).first();
+  }
+
+  static void after_insertion(const_tree_iterator x)
+  {
+    relabel_run(x, x, 1);
+  }
+
+  // Gives the `count` nodes from `first` to `last` labels between the labels
+  // of their neighbours, which must be in order. If there are not enough free
+  // labels, grows an aligned label range around them until it holds few
+  // enough nodes and spreads the nodes in it evenly.
+  static void relabel_run(const_tree_iterator first,
+                          const_tree_iterator last,
+                          label_type count)
+  {
+    const auto p = predecessor(first);
+    const auto s = successor(last);
+
+    const label_type low = !p ? 0 : label(p) + 1;
+    const label_type high = !s ? label_space : label(s);
+
+    if (low < high && high - low >= count)
+    {
+      spread(first, count, low, high - low);
+      return;
+    }
+
+    const label_type anchor = !p ? 0 : label(p);
+
+    unsigned bits = 0;
+    label_type range_begin = anchor;
+    double limit = 1.0;
+
+    do
+    {
+      ++bits;
+      limit *= density;
+
+      range_begin = anchor & ~((label_type(1) << bits) - 1);
+
+      const auto range_end = range_begin + (label_type(1) << bits);
+
+      for (auto y = predecessor(first); !!y && label(y) >= range_begin;
+           y = predecessor(first))
+      {
+        first = y;
+        ++count;
+      }
+
+      for (auto y = successor(last); !!y && label(y) < range_end;
+           y = successor(last))
+      {
+        last = y;
+        ++count;
+      }
+    } while (bits < label_bits && double(count) > limit);
+
+    spread(first, count, range_begin, label_type(1) << bits);
+  }
+
+  // Spreads the labels of the tree with the root `x` over all labels
+  static void relabel(const_tree_iterator x)
+  {
+    if (!x)
+      return;
+
+    label_type count = 0;
+
+    for (auto y = minimum(x); !!y; y = successor(y))
+    {
+      ++count;
+    }
+
+    spread(minimum(x), count, 0, label_space);
+  }
+
+  // Gives `count` nodes starting from `first` evenly spaced labels from
+  // `[begin, begin + size)`
+  static void spread(const_tree_iterator first,
+                     label_type count,
+                     label_type begin,
+                     label_type size)
+  {
+    const auto step = size / count;
+
+    assert(step > 0);
+
+    auto next = begin + step / 2;
+
+    for (auto y = first; count > 0; y = successor(y), --count)
+    {
+      label(y) = next;
+      next += step;
+    }
+  }
 };
 
 } // mixin
@@ -179,6 +383,17 @@ public:
   using type = mixin::ordering<T, M, Allocator, Base>;
 };
 
+class OrderMaintenance
+{
+public:
+  template <typename T,
+            typename M,
+            typename Allocator,
+            template <typename, typename, typename>
+            class Base>
+  using type = mixin::order_maintenance<T, M, Allocator, Base>;
+};
+
 } // binary_tree
 
 } // dst
@@ -0,0 +1,311 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/mixin.h>
+#include <dst/utility.h>
+
+#include <cassert> // assert
+#include <utility> // std::forward, std::move
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+namespace mixin
+{
+
+// Red-black tree. Rebalancing after an insertion or an erasure takes at most
+// two or three rotations respectively, which makes it cheaper than AVL for
+// update-heavy workloads, at the cost of a slightly deeper tree.
+template <typename T,
+          typename M,
+          typename Allocator,
+          template <typename, typename, typename>
+          class Base>
+class rb : public Base<T, pair_or_single<bool, M>, Allocator>
+{
+private:
+  using base = Base<T, pair_or_single<bool, M>, Allocator>;
+
+  static_assert(is_unbalanced_binary_tree<typename base::tree_category>::value,
+                "Base mixin must be unbalanced");
+
+protected:
+  using tree_category = balanced_binary_tree_tag;
+
+  using typename base::const_tree_iterator;
+  using typename base::tree_iterator;
+
+  using typename base::size_type;
+
+  using allocator_type = typename base::allocator_type;
+
+protected:
+  rb()
+  : base()
+  {
+  }
+
+  explicit rb(const allocator_type& allocator)
+  : base(allocator)
+  {
+  }
+
+  explicit rb(const rb& other, const allocator_type& allocator)
+  : base(other, allocator)
+  {
+  }
+
+  rb(rb&& other, const allocator_type& allocator)
+  : base(std::move(other), allocator)
+  {
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_left(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_left(position, std::forward<Args>(args)...);
+
+    after_insertion(x);
+
+    return x;
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_right(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_right(position, std::forward<Args>(args)...);
+
+    after_insertion(x);
+
+    return x;
+  }
+
+  void erase(const_tree_iterator position, const_tree_iterator sub)
+  {
+    assert(!!parent(sub));
+
+    const auto sub_parent = parent(sub);
+    const auto left_erasing = left(sub_parent) == sub;
+    const auto p = sub_parent == position ? sub : sub_parent;
+    const auto child = !!left(sub) ? left(sub) : right(sub);
+    const bool black_erased = !is_red(sub);
+
+    // `sub` takes over the color of `position`
+    base::erase(position, sub);
+
+    if (black_erased)
+      after_erasing(p, child, left_erasing);
+  }
+
+  void erase(const_tree_iterator position)
+  {
+    const auto p = parent(position);
+    const auto left_erasing = !!p && left(p) == position;
+    const auto child = !!left(position) ? left(position) : right(position);
+    const bool black_erased = !is_red(position);
+
+    base::erase(position);
+
+    if (black_erased)
+      after_erasing(p, child, left_erasing);
+  }
+
+  template <typename ForwardIterator>
+  void build(ForwardIterator from, size_type n)
+  {
+    base::build(from, n);
+
+    const auto x = base::root();
+
+    // A built tree is complete except for its deepest level, which is red
+    build_colors(x, 1, leftmost_depth(x) != rightmost_depth(x)
+                         ? rightmost_depth(x)
+                         : 0);
+  }
+
+  static typename ref_or_void<M>::type metadata(const_tree_iterator x)
+  {
+    return base::metadata(x).second();
+  }
+
+public:
+  static bool is_red(const_tree_iterator x)
+  {
+    return !!x && base::metadata(x).first();
+  }
+
+private:
+  static bool& red(const_tree_iterator x)
+  {
+    assert(!!x);
+
+    return base::metadata(x).first();
+  }
+
+  static int leftmost_depth(const_tree_iterator x)
+  {
+    int d = 0;
+
+    for (; !!x; x = left(x))
+    {
+      ++d;
+    }
+
+    return d;
+  }
+
+  static int rightmost_depth(const_tree_iterator x)
+  {
+    int d = 0;
+
+    for (; !!x; x = right(x))
+    {
+      ++d;
+    }
+
+    return d;
+  }
+
+  static void build_colors(const_tree_iterator x, int depth, int red_depth)
+  {
+    if (!x)
+      return;
+
+    red(x) = depth == red_depth;
+
+    build_colors(left(x), depth + 1, red_depth);
+    build_colors(right(x), depth + 1, red_depth);
+  }
+
+  void after_insertion(const_tree_iterator x)
+  {
+    red(x) = true;
+
+    while (is_red(parent(x)))
+    {
+      auto p = parent(x);
+      const auto g = parent(p);
+
+      assert(!!g);
+
+      const bool left_parent = left(g) == p;
+      const auto u = left_parent ? right(g) : left(g);
+
+      if (is_red(u))
+      {
+        red(p) = false;
+        red(u) = false;
+        red(g) = true;
+        x = g;
+
+        continue;
+      }
+
+      if (left_parent && right(p) == x)
+      {
+        p = base::rotate_left(p);
+      }
+      else if (!left_parent && left(p) == x)
+      {
+        p = base::rotate_right(p);
+      }
+
+      red(p) = false;
+      red(g) = true;
+
+      if (left_parent)
+        base::rotate_right(g);
+      else
+        base::rotate_left(g);
+
+      break;
+    }
+
+    red(base::root()) = false;
+  }
+
+  // Restores the black height after a black node was erased from the left or
+  // right subtree of `p`, now rooted at `x`.
+  void
+  after_erasing(const_tree_iterator p, const_tree_iterator x, bool left_erasing)
+  {
+    while (!!p && !is_red(x))
+    {
+      auto w = left_erasing ? right(p) : left(p);
+
+      assert(!!w);
+
+      if (is_red(w))
+      {
+        red(w) = false;
+        red(p) = true;
+
+        if (left_erasing)
+          base::rotate_left(p);
+        else
+          base::rotate_right(p);
+
+        w = left_erasing ? right(p) : left(p);
+      }
+
+      const auto near = left_erasing ? left(w) : right(w);
+      const auto far = left_erasing ? right(w) : left(w);
+
+      if (!is_red(near) && !is_red(far))
+      {
+        red(w) = true;
+        x = p;
+        p = parent(x);
+        left_erasing = !!p && left(p) == x;
+
+        continue;
+      }
+
+      if (!is_red(far))
+      {
+        red(near) = false;
+        red(w) = true;
+
+        w = left_erasing ? base::rotate_right(w) : base::rotate_left(w);
+      }
+
+      red(w) = red(p);
+      red(p) = false;
+      red(left_erasing ? right(w) : left(w)) = false;
+
+      if (left_erasing)
+        base::rotate_left(p);
+      else
+        base::rotate_right(p);
+
+      return;
+    }
+
+    if (!!x)
+      red(x) = false;
+  }
+};
+} // mixin
+
+class RB
+{
+public:
+  template <typename T,
+            typename M,
+            typename Allocator,
+            template <typename, typename, typename>
+            class Base>
+  using type = mixin::rb<T, M, Allocator, Base>;
+};
+
+} // binary_tree
+
+} // dst
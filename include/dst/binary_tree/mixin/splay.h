@@ -0,0 +1,254 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/mixin.h>
+
+#include <cassert> // assert
+#include <utility> // std::forward, std::move, std::pair
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+namespace mixin
+{
+
+// Self-adjusting tree: inserted elements, parents of erased elements and
+// elements looked up through non-const `element_at` are splayed to the root.
+// Insertion, erasure, lookup, split and join take O(log n) amortized time,
+// but a single operation may take O(n). Accessing an element `d` positions
+// away from the previous access takes O(log(d + 1)) amortized time (dynamic
+// finger). Const lookups do not restructure the tree.
+// Every non-const access pays for the rotations that bring the element to
+// the root, so Splay loses to AVL when the balanced tree's search paths stay
+// in cache anyway: for example, `element_at` over a hot window of a few dozen
+// elements runs about 1.3-1.8x slower than on an indexed AVL list (see
+// bench_skewed_element_at). Splay pays off when the accessed elements are far
+// apart in a large tree but few in number, so that their AVL paths keep
+// missing the cache, and for cursor edits whose split and join points are
+// already near the root.
+// The tree may degenerate into a path, so it is tagged as self-adjusting
+// rather than balanced.
+template <typename T,
+          typename M,
+          typename Allocator,
+          template <typename, typename, typename>
+          class Base>
+class splay : public Base<T, M, Allocator>
+{
+private:
+  using base = Base<T, M, Allocator>;
+
+  static_assert(is_unbalanced_binary_tree<typename base::tree_category>::value,
+                "Base mixin must be unbalanced");
+
+protected:
+  using tree_category = joinable_self_adjusting_binary_tree_tag;
+
+  using typename base::const_tree_iterator;
+  using typename base::tree_iterator;
+
+  using typename base::const_iterator;
+  using typename base::iterator;
+
+  using typename base::const_reference;
+  using typename base::reference;
+
+  using typename base::size_type;
+
+  using allocator_type = typename base::allocator_type;
+
+public:
+  // Moves `x` to the root of its tree with zig-zig and zig-zag steps
+  void splay_to_root(const_tree_iterator x)
+  {
+    assert(!!x);
+
+    while (!!parent(x))
+    {
+      const auto p = parent(x);
+      const auto g = parent(p);
+      const bool x_left = left(p) == x;
+
+      if (!g)
+      {
+        rotate_up(p, x_left);
+      }
+      else if ((left(g) == p) == x_left)
+      {
+        rotate_up(g, x_left);
+        rotate_up(p, x_left);
+      }
+      else
+      {
+        rotate_up(p, x_left);
+        rotate_up(g, !x_left);
+      }
+    }
+  }
+
+  void splay_to_root(const_iterator x)
+  {
+    splay_to_root(x.base());
+  }
+
+  const_iterator element_at(size_type index) const
+  {
+    return base::element_at(index);
+  }
+
+  iterator element_at(size_type index)
+  {
+    const auto it = base::element_at(index);
+
+    splay_to_root(it.base());
+
+    return it;
+  }
+
+  const_reference at(size_type index) const
+  {
+    return *element_at(index);
+  }
+
+  reference at(size_type index)
+  {
+    return *element_at(index);
+  }
+
+  const_reference operator[](size_type index) const
+  {
+    return at(index);
+  }
+
+  reference operator[](size_type index)
+  {
+    return at(index);
+  }
+
+protected:
+  splay()
+  : base()
+  {
+  }
+
+  explicit splay(const allocator_type& allocator)
+  : base(allocator)
+  {
+  }
+
+  explicit splay(const splay& other, const allocator_type& allocator)
+  : base(other, allocator)
+  {
+  }
+
+  splay(splay&& other, const allocator_type& allocator)
+  : base(std::move(other), allocator)
+  {
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_left(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_left(position, std::forward<Args>(args)...);
+
+    splay_to_root(x);
+
+    return x;
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_right(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_right(position, std::forward<Args>(args)...);
+
+    splay_to_root(x);
+
+    return x;
+  }
+
+  void erase(const_tree_iterator position, const_tree_iterator sub)
+  {
+    const auto p = parent(sub) == position ? sub : parent(sub);
+
+    base::erase(position, sub);
+
+    splay_to_root(p);
+  }
+
+  void erase(const_tree_iterator position)
+  {
+    const auto p = parent(position);
+
+    base::erase(position);
+
+    if (!!p)
+      splay_to_root(p);
+  }
+
+  // Concatenates the detached trees `x` and `y`. Returns the root of the
+  // resulting detached tree.
+  tree_iterator join(const_tree_iterator x, const_tree_iterator y)
+  {
+    if (!x)
+      return base::iterator_const_cast(y);
+
+    const auto k = maximum(x);
+
+    splay_to_root(k);
+    base::link_right(k, y);
+
+    return base::iterator_const_cast(k);
+  }
+
+  // Splits the tree containing `k` into two detached trees: the elements
+  // before `k` and the elements starting from `k`.
+  std::pair<tree_iterator, tree_iterator> split(const_tree_iterator k)
+  {
+    assert(!!k);
+
+    splay_to_root(k);
+    base::unlink(k);
+
+    const auto l = left(k);
+
+    if (!!l)
+      base::unlink(l);
+
+    return std::make_pair(base::iterator_const_cast(l),
+                          base::iterator_const_cast(k));
+  }
+
+private:
+  // Rotates the child of `x` on the given side into the place of `x`
+  void rotate_up(const_tree_iterator x, bool left_child)
+  {
+    if (left_child)
+      base::rotate_right(x);
+    else
+      base::rotate_left(x);
+  }
+};
+} // mixin
+
+class Splay
+{
+public:
+  template <typename T,
+            typename M,
+            typename Allocator,
+            template <typename, typename, typename>
+            class Base>
+  using type = mixin::splay<T, M, Allocator, Base>;
+};
+
+} // binary_tree
+
+} // dst
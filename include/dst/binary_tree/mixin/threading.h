@@ -0,0 +1,427 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/algorithm.h>
+#include <dst/binary_tree/initializer_tree.h>
+#include <dst/binary_tree/iterator_facade.h>
+#include <dst/binary_tree/mixin.h>
+#include <dst/utility.h>
+
+#include <iterator>    // std::bidirectional_iterator_tag
+#include <memory>      // std::allocator_traits
+#include <type_traits> // std::enable_if, std::is_convertible
+#include <utility>     // std::forward, std::move
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+namespace mixin
+{
+
+namespace detail
+{
+
+template <typename Threading> class threads
+{
+public:
+  typename Threading::tree_iterator prev;
+  typename Threading::tree_iterator next;
+};
+}
+
+// Links every node to its in-order neighbours, so that iterators move in
+// constant time. The nil node closes the chain into a ring: its `next` is the
+// first element and its `prev` is the last one.
+// Linking and unlinking subtrees walks the boundary of the moved subtree, which
+// adds O(log n) to every link and makes split O(log^2 n).
+template <typename T,
+          typename M,
+          typename Allocator,
+          template <typename, typename, typename>
+          class Base>
+class threading
+: public Base<T,
+              pair_or_single<detail::threads<threading<T, M, Allocator, Base>>,
+                             M>,
+              Allocator>
+{
+private:
+  using base =
+    Base<T,
+         pair_or_single<detail::threads<threading<T, M, Allocator, Base>>, M>,
+         Allocator>;
+
+  static_assert(is_unbalanced_binary_tree<typename base::tree_category>::value,
+                "Base mixin must be unbalanced");
+
+  friend class detail::threads<threading>;
+
+protected:
+  using typename base::const_tree_iterator;
+  using typename base::tree_iterator;
+
+  using typename base::size_type;
+
+  using allocator_type = typename base::allocator_type;
+
+private:
+  template <typename BinaryTreeIterator>
+  class iterator_base
+  : public iterator_facade<
+      iterator_base<BinaryTreeIterator>,
+      std::bidirectional_iterator_tag,
+      typename std::iterator_traits<BinaryTreeIterator>::value_type>
+  {
+  private:
+    friend iterator_facade<
+      iterator_base<BinaryTreeIterator>,
+      std::bidirectional_iterator_tag,
+      typename std::iterator_traits<BinaryTreeIterator>::value_type>;
+
+  public:
+    explicit iterator_base(BinaryTreeIterator position = BinaryTreeIterator())
+    : position_(position)
+    {
+    }
+
+    template <
+      typename OtherIterator,
+      typename = typename std::enable_if<
+        std::is_convertible<OtherIterator, BinaryTreeIterator>::value>::type>
+    iterator_base(const iterator_base<OtherIterator>& other)
+    : iterator_base(static_cast<BinaryTreeIterator>(other.base()))
+    {
+    }
+
+    BinaryTreeIterator base() const
+    {
+      return position_;
+    }
+
+    friend bool operator==(const iterator_base& lhs, const iterator_base& rhs)
+    {
+      return lhs.position_ == rhs.position_;
+    }
+
+  private:
+    typename iterator_base::reference value() const
+    {
+      return *position_;
+    }
+
+    void move_forward()
+    {
+      position_ = next(position_);
+    }
+
+    void move_back()
+    {
+      position_ = prev(position_);
+    }
+
+  private:
+    BinaryTreeIterator position_;
+  };
+
+protected:
+  using iterator = iterator_base<tree_iterator>;
+  using const_iterator = iterator_base<const_tree_iterator>;
+
+protected:
+  threading()
+  : base()
+  {
+    rethread();
+  }
+
+  explicit threading(const allocator_type& allocator)
+  : base(allocator)
+  {
+    rethread();
+  }
+
+  threading(const threading& other)
+  : base(other)
+  {
+    rethread();
+  }
+
+  threading(threading&& other)
+  : base(std::move(other))
+  {
+    other.rethread();
+  }
+
+  explicit threading(const threading& other, const allocator_type& allocator)
+  : base(other, allocator)
+  {
+    rethread();
+  }
+
+  threading(threading&& other, const allocator_type& allocator)
+  : base(std::move(other), allocator)
+  {
+    if (allocator == other.get_allocator())
+      other.rethread();
+    else
+      rethread();
+  }
+
+  threading(const initializer_tree<T>& init, const allocator_type& allocator)
+  : base(init, allocator)
+  {
+    rethread();
+  }
+
+  threading& operator=(const threading& other)
+  {
+    base::operator=(other);
+
+    rethread();
+
+    return *this;
+  }
+
+  threading& operator=(threading&& other)
+  {
+    const bool nodes_moved =
+      std::allocator_traits<
+        allocator_type>::propagate_on_container_move_assignment::value ||
+      base::get_allocator() == other.get_allocator();
+
+    base::operator=(std::move(other));
+
+    if (nodes_moved)
+      other.rethread();
+    else
+      rethread();
+
+    return *this;
+  }
+
+  iterator begin()
+  {
+    return iterator(next(base::nil()));
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(next(base::nil()));
+  }
+
+  iterator end()
+  {
+    return iterator(base::nil());
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(base::nil());
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_left(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_left(position, std::forward<Args>(args)...);
+
+    stitch(prev(position), x);
+    stitch(x, position);
+
+    return x;
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_right(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_right(position, std::forward<Args>(args)...);
+
+    stitch(x, next(position));
+    stitch(position, x);
+
+    return x;
+  }
+
+  void erase(const_tree_iterator position, const_tree_iterator sub)
+  {
+    const auto position_prev = prev(position);
+    const auto position_next = next(position);
+    const auto sub_prev = prev(sub);
+    const auto sub_next = next(sub);
+
+    // `sub` takes over the metadata of `position`, threads included
+    base::erase(position, sub);
+
+    if (sub == position_next)
+    {
+      stitch(position_prev, sub);
+      stitch(sub, sub_next);
+    }
+    else
+    {
+      stitch(sub_prev, sub);
+      stitch(sub, position_next);
+    }
+  }
+
+  void erase(const_tree_iterator position)
+  {
+    const auto position_prev = prev(position);
+    const auto position_next = next(position);
+
+    base::erase(position);
+
+    stitch(position_prev, position_next);
+  }
+
+  void clear()
+  {
+    base::clear();
+
+    rethread();
+  }
+
+  template <typename ForwardIterator>
+  void build(ForwardIterator from, size_type n)
+  {
+    base::build(from, n);
+
+    rethread();
+  }
+
+  void link_left(const_tree_iterator position, const_tree_iterator x)
+  {
+    base::link_left(position, x);
+
+    link_boundaries(position, x);
+  }
+
+  void link_right(const_tree_iterator position, const_tree_iterator x)
+  {
+    base::link_right(position, x);
+
+    link_boundaries(position, x);
+  }
+
+  void unlink(const_tree_iterator x)
+  {
+    const auto x_prev = before(x);
+    const auto x_next = after(x);
+
+    base::unlink(x);
+
+    stitch(x_prev, x_next);
+  }
+
+  static typename ref_or_void<M>::type metadata(const_tree_iterator x)
+  {
+    return base::metadata(x).second();
+  }
+
+private:
+  static tree_iterator& prev(const_tree_iterator x)
+  {
+    return base::metadata(x).first().prev;
+  }
+
+  static tree_iterator& next(const_tree_iterator x)
+  {
+    return base::metadata(x).first().next;
+  }
+
+  // Makes `y` follow `x`. A default constructed iterator stands for the
+  // unknown neighbour of a detached subtree and is left untouched.
+  void stitch(const_tree_iterator x, const_tree_iterator y)
+  {
+    if (x != const_tree_iterator())
+      next(x) = base::iterator_const_cast(y);
+
+    if (y != const_tree_iterator())
+      prev(y) = base::iterator_const_cast(x);
+  }
+
+  // The node preceding the subtree `x`, nil if `x` starts the container or a
+  // default constructed iterator if `x` starts a detached subtree.
+  tree_iterator before(const_tree_iterator x)
+  {
+    auto p = parent(x);
+
+    while (!!p && left(p) == x)
+    {
+      x = p;
+      p = parent(x);
+    }
+
+    if (!!p)
+      return base::iterator_const_cast(p);
+
+    return base::root() == x ? base::nil() : tree_iterator();
+  }
+
+  tree_iterator after(const_tree_iterator x)
+  {
+    auto p = parent(x);
+
+    while (!!p && right(p) == x)
+    {
+      x = p;
+      p = parent(x);
+    }
+
+    if (!!p)
+      return base::iterator_const_cast(p);
+
+    return base::root() == x ? base::nil() : tree_iterator();
+  }
+
+  void link_boundaries(const_tree_iterator position, const_tree_iterator x)
+  {
+    if (!x)
+    {
+      if (!position)
+        stitch(base::nil(), base::nil());
+
+      return;
+    }
+
+    stitch(before(x), minimum(x));
+    stitch(maximum(x), after(x));
+  }
+
+  void rethread()
+  {
+    tree_iterator x = base::nil();
+
+    for (auto y = minimum(base::root()); !!y; y = successor(y))
+    {
+      stitch(x, y);
+      x = y;
+    }
+
+    stitch(x, base::nil());
+  }
+};
+
+} // mixin
+
+class Threading
+{
+public:
+  template <typename T,
+            typename M,
+            typename Allocator,
+            template <typename, typename, typename>
+            class Base>
+  using type = mixin::threading<T, M, Allocator, Base>;
+};
+
+} // binary_tree
+
+} // dst
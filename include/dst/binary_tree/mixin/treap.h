@@ -0,0 +1,331 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/mixin.h>
+#include <dst/utility.h>
+
+#include <cassert>    // assert
+#include <cstdint>    // std::uint32_t, std::uint64_t
+#include <functional> // std::hash
+#include <random>     // std::random_device
+#include <thread>     // std::this_thread
+#include <utility>    // std::forward, std::move, std::pair, std::swap
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+namespace detail
+{
+
+// A seed which neither the input nor other threads and runs can predict:
+// entropy mixed with the id of the thread, in case the device is a
+// deterministic one
+inline std::uint32_t random_priority_seed()
+{
+  std::random_device device;
+
+  std::uint64_t x = (std::uint64_t(device()) << 32) ^ device() ^
+                    std::hash<std::thread::id>()(std::this_thread::get_id());
+
+  // Finalizer of MurmurHash3
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+
+  // Xorshift never leaves the zero state
+  return static_cast<std::uint32_t>(x) | 1;
+}
+
+// State of the xorshift generator of the thread, so that treaps need no state
+inline std::uint32_t& random_priority_state()
+{
+  thread_local std::uint32_t state = random_priority_seed();
+
+  return state;
+}
+
+inline std::uint32_t random_priority()
+{
+  std::uint32_t& state = random_priority_state();
+
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+
+  return state;
+}
+
+} // detail
+
+// Reseeds the priorities which the calling thread gives to the nodes of
+// treaps, so that their shapes can be reproduced, e.g. in tests
+inline void seed_random_priorities(std::uint32_t seed)
+{
+  detail::random_priority_state() = seed == 0 ? 1 : seed;
+}
+
+namespace mixin
+{
+
+// Treap: every node gets a random priority, and the tree is kept a max-heap
+// on the priorities. The expected depth is O(log n) whatever the order of
+// operations, and split and join reduce to moving a single node to the root
+// or away from it with rotations, in O(log n) expected time.
+// An erased node is rotated down to where it has at most one child, so the
+// other nodes keep their priorities and the shape of the tree does not depend
+// on the history of erasures.
+template <typename T,
+          typename M,
+          typename Allocator,
+          template <typename, typename, typename>
+          class Base>
+class treap : public Base<T, pair_or_single<std::uint32_t, M>, Allocator>
+{
+private:
+  using base = Base<T, pair_or_single<std::uint32_t, M>, Allocator>;
+
+  static_assert(is_unbalanced_binary_tree<typename base::tree_category>::value,
+                "Base mixin must be unbalanced");
+
+protected:
+  using tree_category = joinable_balanced_binary_tree_tag;
+
+  using typename base::const_tree_iterator;
+  using typename base::tree_iterator;
+
+  using typename base::size_type;
+
+  using allocator_type = typename base::allocator_type;
+
+protected:
+  treap()
+  : base()
+  {
+  }
+
+  explicit treap(const allocator_type& allocator)
+  : base(allocator)
+  {
+  }
+
+  explicit treap(const treap& other, const allocator_type& allocator)
+  : base(other, allocator)
+  {
+  }
+
+  treap(treap&& other, const allocator_type& allocator)
+  : base(std::move(other), allocator)
+  {
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_left(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_left(position, std::forward<Args>(args)...);
+
+    after_insertion(x);
+
+    return x;
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_right(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_right(position, std::forward<Args>(args)...);
+
+    after_insertion(x);
+
+    return x;
+  }
+
+  // `sub` is ignored: `position` is rotated down instead of being replaced
+  void erase(const_tree_iterator position, const_tree_iterator)
+  {
+    erase(position);
+  }
+
+  void erase(const_tree_iterator position)
+  {
+    while (!!left(position) && !!right(position))
+    {
+      rotate_up(higher_child(position));
+    }
+
+    base::erase(position);
+  }
+
+  template <typename ForwardIterator>
+  void build(ForwardIterator from, size_type n)
+  {
+    base::build(from, n);
+
+    build_priorities(base::root());
+  }
+
+  // Concatenates the detached trees `x` and `y`. Returns the root of the
+  // resulting detached tree.
+  tree_iterator join(const_tree_iterator x, const_tree_iterator y)
+  {
+    if (!x)
+      return base::iterator_const_cast(y);
+
+    if (!y)
+      return base::iterator_const_cast(x);
+
+    // The minimum of `y` becomes the root of both trees and then sinks
+    const auto k = minimum(y);
+
+    raise_to_root(k);
+
+    const auto rest = right(k);
+
+    if (!!rest)
+      base::unlink(rest);
+
+    base::link_left(k, x);
+    base::link_right(k, rest);
+
+    return sink(k);
+  }
+
+  // Splits the tree containing `k` into two detached trees: the elements
+  // before `k` and the elements starting from `k`.
+  std::pair<tree_iterator, tree_iterator> split(const_tree_iterator k)
+  {
+    assert(!!k);
+
+    raise_to_root(k);
+    base::unlink(k);
+
+    const auto l = left(k);
+
+    if (!!l)
+      base::unlink(l);
+
+    return std::make_pair(base::iterator_const_cast(l), sink(k));
+  }
+
+  static typename ref_or_void<M>::type metadata(const_tree_iterator x)
+  {
+    return base::metadata(x).second();
+  }
+
+public:
+  static std::uint32_t priority(const_tree_iterator x)
+  {
+    assert(!!x);
+
+    return base::metadata(x).first();
+  }
+
+private:
+  static std::uint32_t& priority_ref(const_tree_iterator x)
+  {
+    assert(!!x);
+
+    return base::metadata(x).first();
+  }
+
+  // Gives random priorities to the nodes of the subtree `x` and restores the
+  // heap order by exchanging them, leaving the shape intact
+  static void build_priorities(const_tree_iterator x)
+  {
+    if (!x)
+      return;
+
+    build_priorities(left(x));
+    build_priorities(right(x));
+
+    priority_ref(x) = binary_tree::detail::random_priority();
+
+    for (auto c = higher_child(x); !!c && priority(c) > priority(x);
+         x = c, c = higher_child(x))
+    {
+      std::swap(priority_ref(c), priority_ref(x));
+    }
+  }
+
+  static const_tree_iterator higher_child(const_tree_iterator x)
+  {
+    const auto l = left(x);
+    const auto r = right(x);
+
+    if (!l)
+      return r;
+
+    if (!r)
+      return l;
+
+    return priority(l) < priority(r) ? r : l;
+  }
+
+  // Rotates the child `x` into the place of its parent, returns `x`
+  tree_iterator rotate_up(const_tree_iterator x)
+  {
+    const auto p = parent(x);
+
+    return left(p) == x ? base::rotate_right(p) : base::rotate_left(p);
+  }
+
+  void raise_to_root(const_tree_iterator x)
+  {
+    while (!!parent(x))
+    {
+      rotate_up(x);
+    }
+  }
+
+  void after_insertion(const_tree_iterator x)
+  {
+    priority_ref(x) = binary_tree::detail::random_priority();
+
+    while (!!parent(x) && priority(parent(x)) < priority(x))
+    {
+      rotate_up(x);
+    }
+  }
+
+  // Moves the root `x` down until its children have lower priorities,
+  // returns the new root
+  tree_iterator sink(const_tree_iterator x)
+  {
+    auto root = base::iterator_const_cast(x);
+
+    for (auto c = higher_child(x); !!c && priority(c) > priority(x);
+         c = higher_child(x))
+    {
+      const auto y = rotate_up(c);
+
+      if (root == x)
+        root = y;
+    }
+
+    return root;
+  }
+};
+} // mixin
+
+class Treap
+{
+public:
+  template <typename T,
+            typename M,
+            typename Allocator,
+            template <typename, typename, typename>
+            class Base>
+  using type = mixin::treap<T, M, Allocator, Base>;
+};
+
+} // binary_tree
+
+} // dst
@@ -0,0 +1,341 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/mixin.h>
+#include <dst/utility.h>
+
+#include <array>
+#include <cassert> // assert
+#include <cstddef> // std::size_t
+#include <limits>  // std::numeric_limits
+#include <utility> // std::forward, std::move, std::pair
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+namespace mixin
+{
+
+// Weight-balanced tree (BB[alpha]) which balances on the subtree sizes kept by
+// `Indexing`, so it must be stacked right above it and stores nothing itself.
+// The weight of a subtree is its size plus one; siblings never differ in
+// weight by more than a factor of `delta`.
+template <typename T,
+          typename M,
+          typename Allocator,
+          template <typename, typename, typename>
+          class Base>
+class wb : public Base<T, M, Allocator>
+{
+private:
+  using base = Base<T, M, Allocator>;
+
+  static_assert(is_unbalanced_binary_tree<typename base::tree_category>::value,
+                "Base mixin must be unbalanced");
+
+  static_assert(base::keeps_subtree_sizes,
+                "Indexing must be stacked below WB");
+
+protected:
+  using tree_category = joinable_balanced_binary_tree_tag;
+
+  using typename base::const_tree_iterator;
+  using typename base::tree_iterator;
+
+  using typename base::size_type;
+
+  using allocator_type = typename base::allocator_type;
+
+protected:
+  wb()
+  : base()
+  {
+  }
+
+  explicit wb(const allocator_type& allocator)
+  : base(allocator)
+  {
+  }
+
+  explicit wb(const wb& other, const allocator_type& allocator)
+  : base(other, allocator)
+  {
+  }
+
+  wb(wb&& other, const allocator_type& allocator)
+  : base(std::move(other), allocator)
+  {
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_left(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_left(position, std::forward<Args>(args)...);
+
+    rebalance_path(parent(x));
+
+    return x;
+  }
+
+  template <typename... Args>
+  tree_iterator emplace_right(const_tree_iterator position, Args&&... args)
+  {
+    const auto x = base::emplace_right(position, std::forward<Args>(args)...);
+
+    rebalance_path(parent(x));
+
+    return x;
+  }
+
+  void erase(const_tree_iterator position, const_tree_iterator sub)
+  {
+    const auto p = parent(sub) == position ? sub : parent(sub);
+
+    base::erase(position, sub);
+
+    rebalance_path(p);
+  }
+
+  void erase(const_tree_iterator position)
+  {
+    const auto p = parent(position);
+
+    base::erase(position);
+
+    rebalance_path(p);
+  }
+
+  // Joins the detached trees `x` and `y` through the detached node `k`, which
+  // goes between them. Returns the root of the resulting detached tree.
+  tree_iterator
+  join(const_tree_iterator x, const_tree_iterator k, const_tree_iterator y)
+  {
+    assert(!!k && !left(k) && !right(k) && !parent(k));
+
+    if (heavier(y, x))
+    {
+      auto p = y;
+      auto c = left(y);
+
+      while (heavier(c, x))
+      {
+        p = c;
+        c = left(c);
+      }
+
+      if (!!c)
+        base::unlink(c);
+
+      base::link_left(k, x);
+      base::link_right(k, c);
+      base::link_left(p, k);
+
+      return rebalance_path(p);
+    }
+
+    if (heavier(x, y))
+    {
+      auto p = x;
+      auto c = right(x);
+
+      while (heavier(c, y))
+      {
+        p = c;
+        c = right(c);
+      }
+
+      if (!!c)
+        base::unlink(c);
+
+      base::link_left(k, c);
+      base::link_right(k, y);
+      base::link_right(p, k);
+
+      return rebalance_path(p);
+    }
+
+    base::link_left(k, x);
+    base::link_right(k, y);
+
+    return base::iterator_const_cast(k);
+  }
+
+  // Concatenates the detached trees `x` and `y`. Returns the root of the
+  // resulting detached tree.
+  tree_iterator join(const_tree_iterator x, const_tree_iterator y)
+  {
+    if (!x)
+      return base::iterator_const_cast(y);
+
+    if (!y)
+      return base::iterator_const_cast(x);
+
+    const auto k = minimum(y);
+
+    auto rest = right(k);
+
+    if (!!rest)
+      base::unlink(rest);
+
+    if (k != y)
+    {
+      const auto p = parent(k);
+
+      base::unlink(k);
+      base::link_left(p, rest);
+
+      rest = rebalance_path(p);
+    }
+
+    return join(x, k, rest);
+  }
+
+  // Splits the tree containing `k` into two detached trees: the elements
+  // before `k` and the elements starting from `k`.
+  std::pair<tree_iterator, tree_iterator> split(const_tree_iterator k)
+  {
+    assert(!!k);
+
+    struct path_node
+    {
+      const_tree_iterator x;
+      const_tree_iterator other;
+      bool went_left;
+    };
+
+    std::array<path_node, max_height> path;
+    std::size_t depth = 0;
+
+    for (auto x = k; !!x; ++x)
+    {
+      assert(depth < max_height);
+
+      path[depth++].x = x;
+    }
+
+    for (std::size_t i = depth - 1; i > 0; --i)
+    {
+      auto& n = path[i];
+
+      n.went_left = left(n.x) == path[i - 1].x;
+      n.other = n.went_left ? right(n.x) : left(n.x);
+    }
+
+    const auto k_left = left(k);
+    const auto k_right = right(k);
+
+    base::unlink(path[depth - 1].x);
+
+    for (std::size_t i = depth - 1; i > 0; --i)
+    {
+      base::unlink(path[i - 1].x);
+
+      if (!!path[i].other)
+        base::unlink(path[i].other);
+    }
+
+    if (!!k_left)
+      base::unlink(k_left);
+
+    if (!!k_right)
+      base::unlink(k_right);
+
+    auto l = base::iterator_const_cast(k_left);
+    auto r = join(const_tree_iterator(), k, k_right);
+
+    for (std::size_t i = 1; i < depth; ++i)
+    {
+      const auto& n = path[i];
+
+      if (n.went_left)
+        r = join(r, n.x, n.other);
+      else
+        l = join(n.other, n.x, l);
+    }
+
+    return std::make_pair(l, r);
+  }
+
+private:
+  // Hirai and Yamamoto's parameters, the only integer pair for which single
+  // and double rotations restore the balance after every update
+  static constexpr std::size_t delta = 3;
+  static constexpr std::size_t gamma = 2;
+
+  // Weight-balanced tree height never exceeds log(n) / log(4 / 3)
+  static constexpr std::size_t max_height =
+    std::numeric_limits<size_type>::digits * 5 / 2;
+
+  static std::size_t weight(const_tree_iterator x)
+  {
+    return !x ? 1 : base::subtree_size(x) + 1;
+  }
+
+  // `true` if `x` is too heavy to be a sibling of `y`
+  static bool heavier(const_tree_iterator x, const_tree_iterator y)
+  {
+    return delta * weight(y) < weight(x);
+  }
+
+  tree_iterator rebalance(const_tree_iterator x)
+  {
+    const auto l = left(x);
+    const auto r = right(x);
+
+    if (heavier(r, l))
+    {
+      if (weight(left(r)) >= gamma * weight(right(r)))
+        base::rotate_right(r);
+
+      return base::rotate_left(x);
+    }
+
+    if (heavier(l, r))
+    {
+      if (weight(right(l)) >= gamma * weight(left(l)))
+        base::rotate_left(l);
+
+      return base::rotate_right(x);
+    }
+
+    return base::iterator_const_cast(x);
+  }
+
+  // Rebalances `x` and its ancestors, returns the root
+  tree_iterator rebalance_path(const_tree_iterator x)
+  {
+    auto root = base::iterator_const_cast(x);
+
+    while (!!x)
+    {
+      root = rebalance(x);
+      x = parent(root);
+    }
+
+    return root;
+  }
+};
+} // mixin
+
+class WB
+{
+public:
+  template <typename T,
+            typename M,
+            typename Allocator,
+            template <typename, typename, typename>
+            class Base>
+  using type = mixin::wb<T, M, Allocator, Base>;
+};
+
+} // binary_tree
+
+} // dst
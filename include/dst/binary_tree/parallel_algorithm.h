@@ -0,0 +1,367 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/algorithm.h>
+#include <dst/binary_tree/parallel_policy.h>
+
+#include <cstddef>      // std::size_t
+#include <future>       // std::async, std::future
+#include <system_error> // std::system_error
+#include <type_traits>  // std::remove_const
+#include <utility>      // std::declval, std::move
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+namespace detail
+{
+
+// Tells how to split threads between the subtrees of a node: by their sizes
+// if the tree keeps them (see `Indexing`), in halves otherwise
+template <typename Tree, typename = void> struct thread_split
+{
+  template <typename BinaryTreeIterator>
+  static unsigned left_threads(BinaryTreeIterator, unsigned threads)
+  {
+    return threads / 2;
+  }
+};
+
+template <typename Tree>
+struct thread_split<Tree,
+                    decltype(Tree::subtree_size(
+                               std::declval<typename Tree::tree_iterator>()),
+                             void())>
+{
+  template <typename BinaryTreeIterator>
+  static unsigned left_threads(BinaryTreeIterator x, unsigned threads)
+  {
+    const auto n = Tree::subtree_size(x);
+    const auto l = Tree::subtree_size(left(x));
+
+    const auto result = static_cast<unsigned>((threads * l + n / 2) / n);
+
+    return result < 1 ? 1 : result < threads ? result : threads - 1;
+  }
+};
+
+// Calls `f` with the elements of the non-empty subtree `x` in order
+template <typename BinaryTreeIterator, typename Function>
+void for_each_in_subtree(BinaryTreeIterator x, Function& f)
+{
+  const auto last = maximum(x);
+
+  for (auto y = minimum(x);; y = successor(y))
+  {
+    f(*y);
+
+    if (y == last)
+      break;
+  }
+}
+
+// The topmost node of the subtree `x` with two children, nil if there is
+// none. The nodes above it have one child each.
+template <typename BinaryTreeIterator>
+BinaryTreeIterator topmost_fork(BinaryTreeIterator x)
+{
+  while (!!x && (!left(x) || !right(x)))
+  {
+    x = !left(x) ? right(x) : left(x);
+  }
+
+  return x;
+}
+
+template <typename Tree, typename BinaryTreeIterator, typename Function>
+void for_each_parallel(BinaryTreeIterator x, Function& f, unsigned threads);
+
+// Calls `f` with the elements of the subtree `x`, which has two children, in
+// order, visiting its left subtree on another thread
+template <typename Tree, typename BinaryTreeIterator, typename Function>
+void for_each_fork(BinaryTreeIterator x, Function& f, unsigned threads)
+{
+  const auto left_threads = thread_split<Tree>::left_threads(x, threads);
+  const auto y = left(x);
+
+  std::future<void> left_task;
+
+  try
+  {
+    left_task = std::async(std::launch::async, [y, &f, left_threads]() {
+      for_each_parallel<Tree>(y, f, left_threads);
+    });
+  }
+  catch (const std::system_error&)
+  {
+    return for_each_in_subtree(x, f);
+  }
+
+  f(*x);
+  for_each_parallel<Tree>(right(x), f, threads - left_threads);
+
+  left_task.get();
+}
+
+// The nodes with one child above the topmost fork are visited in a loop, so
+// that degenerate trees do not nest calls deeply
+template <typename Tree, typename BinaryTreeIterator, typename Function>
+void for_each_parallel(BinaryTreeIterator x, Function& f, unsigned threads)
+{
+  if (!x)
+    return;
+
+  if (threads <= 1)
+    return for_each_in_subtree(x, f);
+
+  const auto z = topmost_fork(x);
+
+  if (!z)
+    return for_each_in_subtree(x, f);
+
+  const auto first = minimum(z);
+  const auto last = maximum(x);
+
+  for (auto y = minimum(x); y != first; y = successor(y))
+  {
+    f(*y);
+  }
+
+  for_each_fork<Tree>(z, f, threads);
+
+  for (auto y = maximum(z); y != last;)
+  {
+    y = successor(y);
+    f(*y);
+  }
+}
+
+// Folds the elements from `first` to `last` inclusive in order into `init`
+template <typename BinaryTreeIterator, typename T, typename BinaryOperation>
+T reduce_range(BinaryTreeIterator first,
+               BinaryTreeIterator last,
+               T init,
+               BinaryOperation& op)
+{
+  for (;; first = successor(first))
+  {
+    init = op(std::move(init), *first);
+
+    if (first == last)
+      return init;
+  }
+}
+
+// Folds the non-empty subtree `x` in order into `init`
+template <typename BinaryTreeIterator, typename T, typename BinaryOperation>
+T reduce_subtree(BinaryTreeIterator x, T init, BinaryOperation& op)
+{
+  return reduce_range(minimum(x), maximum(x), std::move(init), op);
+}
+
+// Folds the non-empty subtree `x` in order, starting from its first element
+template <typename T, typename BinaryTreeIterator, typename BinaryOperation>
+T reduce_subtree(BinaryTreeIterator x, BinaryOperation& op)
+{
+  const auto first = minimum(x);
+  const auto last = maximum(x);
+
+  T init(*first);
+
+  if (first == last)
+    return init;
+
+  return reduce_range(successor(first), last, std::move(init), op);
+}
+
+template <typename Tree,
+          typename T,
+          typename BinaryTreeIterator,
+          typename BinaryOperation>
+T reduce_parallel(BinaryTreeIterator x, BinaryOperation& op, unsigned threads);
+
+// Folds the elements of the subtree `x` after its subtree `z` into `init`
+template <typename T, typename BinaryTreeIterator, typename BinaryOperation>
+T reduce_after(BinaryTreeIterator x,
+               BinaryTreeIterator z,
+               T init,
+               BinaryOperation& op)
+{
+  const auto first = maximum(z);
+  const auto last = maximum(x);
+
+  if (first == last)
+    return init;
+
+  return reduce_range(successor(first), last, std::move(init), op);
+}
+
+// Folds the subtree `z` of `x`, which has two children, and then the rest of
+// `x` after it. The left subtree of `z` is folded by `fold_left` on some of
+// the `threads`. The right one is folded on another thread, starting from its
+// own first element, and then folded into the left part.
+template <typename Tree,
+          typename T,
+          typename BinaryTreeIterator,
+          typename BinaryOperation,
+          typename LeftFold>
+T reduce_fork(BinaryTreeIterator x,
+              BinaryTreeIterator z,
+              BinaryOperation& op,
+              unsigned threads,
+              LeftFold fold_left)
+{
+  const auto y = right(z);
+  const auto right_threads =
+    threads - thread_split<Tree>::left_threads(z, threads);
+
+  std::future<T> right_task;
+
+  try
+  {
+    right_task = std::async(std::launch::async, [y, &op, right_threads]() {
+      return reduce_parallel<Tree, T>(y, op, right_threads);
+    });
+  }
+  catch (const std::system_error&)
+  {
+    return reduce_after<T>(
+      x, z, reduce_subtree(y, op(fold_left(left(z), 1u), *z), op), op);
+  }
+
+  auto result = op(fold_left(left(z), threads - right_threads), *z);
+
+  return reduce_after<T>(x, z, op(std::move(result), right_task.get()), op);
+}
+
+// Folds the subtree `x` in order into `init` on up to `threads` threads. The
+// nodes with one child above the topmost fork are folded in a loop, so that
+// degenerate trees do not nest calls deeply.
+template <typename Tree,
+          typename BinaryTreeIterator,
+          typename T,
+          typename BinaryOperation>
+T reduce_parallel(BinaryTreeIterator x,
+                  T init,
+                  BinaryOperation& op,
+                  unsigned threads)
+{
+  if (!x)
+    return init;
+
+  if (threads <= 1)
+    return reduce_subtree(x, std::move(init), op);
+
+  const auto z = topmost_fork(x);
+
+  if (!z)
+    return reduce_subtree(x, std::move(init), op);
+
+  const auto first = minimum(z);
+
+  for (auto w = minimum(x); w != first; w = successor(w))
+  {
+    init = op(std::move(init), *w);
+  }
+
+  return reduce_fork<Tree, T>(
+    x, z, op, threads, [&init, &op](BinaryTreeIterator l, unsigned t) {
+      return reduce_parallel<Tree>(l, std::move(init), op, t);
+    });
+}
+
+// Folds the non-empty subtree `x` in order, starting from its first element
+template <typename Tree,
+          typename T,
+          typename BinaryTreeIterator,
+          typename BinaryOperation>
+T reduce_parallel(BinaryTreeIterator x, BinaryOperation& op, unsigned threads)
+{
+  if (threads <= 1)
+    return reduce_subtree<T>(x, op);
+
+  const auto z = topmost_fork(x);
+
+  if (!z)
+    return reduce_subtree<T>(x, op);
+
+  const auto first = minimum(x);
+  const auto z_first = minimum(z);
+
+  if (first == z_first)
+  {
+    return reduce_fork<Tree, T>(
+      x, z, op, threads, [&op](BinaryTreeIterator l, unsigned t) {
+        return reduce_parallel<Tree, T>(l, op, t);
+      });
+  }
+
+  T init(*first);
+
+  for (auto w = successor(first); w != z_first; w = successor(w))
+  {
+    init = op(std::move(init), *w);
+  }
+
+  return reduce_fork<Tree, T>(
+    x, z, op, threads, [&init, &op](BinaryTreeIterator l, unsigned t) {
+      return reduce_parallel<Tree>(l, std::move(init), op, t);
+    });
+}
+
+} // detail
+
+/// Calls `f` with every element of `tree`, visiting disjoint subtrees on up
+/// to `policy.threads()` threads at once; the elements of each subtree are
+/// visited in order. Threads are split between subtrees by their sizes if the
+/// tree keeps them. `f` is shared by all the threads.
+template <typename BinaryTree, typename Function>
+void parallel_for_each(BinaryTree& tree,
+                       Function f,
+                       const parallel_policy& policy)
+{
+  detail::for_each_parallel<typename std::remove_const<BinaryTree>::type>(
+    tree.root(), f, policy.threads_for(tree.size()));
+}
+
+/// Same with the tree's own policy
+template <typename BinaryTree, typename Function>
+void parallel_for_each(BinaryTree& tree, Function f)
+{
+  parallel_for_each(tree, f, tree.get_parallel_policy());
+}
+
+/// Folds the elements of `tree` in order into `init` with `op`, like
+/// `std::reduce`, on up to `policy.threads()` threads. The elements are never
+/// reordered, so `op` need not be commutative, only associative, and must
+/// accept any mix of `T` and elements. A fold over a subtree on another
+/// thread starts from the subtree's first element converted to `T`.
+template <typename BinaryTree, typename T, typename BinaryOperation>
+T parallel_reduce(const BinaryTree& tree,
+                  T init,
+                  BinaryOperation op,
+                  const parallel_policy& policy)
+{
+  return detail::reduce_parallel<BinaryTree>(
+    tree.root(), std::move(init), op, policy.threads_for(tree.size()));
+}
+
+/// Same with the tree's own policy
+template <typename BinaryTree, typename T, typename BinaryOperation>
+T parallel_reduce(const BinaryTree& tree, T init, BinaryOperation op)
+{
+  return parallel_reduce(
+    tree, std::move(init), op, tree.get_parallel_policy());
+}
+
+} // binary_tree
+
+} // dst
@@ -0,0 +1,64 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <cstddef> // std::size_t
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+// Tells a tree how many threads it may use to copy, move to another allocator
+// and clear itself. Trees of at least `cutoff` elements hand whole subtrees
+// to up to `threads` threads, provided `is_thread_safe_allocator` holds for
+// their allocator (it does for `std::allocator`). Trees with other
+// allocators, like `pool_allocator`, ignore the policy and stay sequential.
+// The default policy is sequential.
+class parallel_policy
+{
+public:
+  static constexpr std::size_t default_cutoff = std::size_t(1) << 15;
+
+  parallel_policy()
+  : threads_(1)
+  , cutoff_(default_cutoff)
+  {
+  }
+
+  explicit parallel_policy(unsigned threads,
+                           std::size_t cutoff = default_cutoff)
+  : threads_(threads > 0 ? threads : 1)
+  , cutoff_(cutoff)
+  {
+  }
+
+  unsigned threads() const
+  {
+    return threads_;
+  }
+
+  std::size_t cutoff() const
+  {
+    return cutoff_;
+  }
+
+  // Number of threads to use for a tree of `n` elements
+  unsigned threads_for(std::size_t n) const
+  {
+    return n < cutoff_ ? 1 : threads_;
+  }
+
+private:
+  unsigned threads_;
+  std::size_t cutoff_;
+};
+
+} // binary_tree
+
+} // dst
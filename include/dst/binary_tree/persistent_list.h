@@ -0,0 +1,790 @@
+
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include "mixin/treap.h"
+
+#include <dst/iterator_facade.h>
+
+#include <algorithm>        // std::equal
+#include <array>
+#include <atomic>           // std::atomic
+#include <cassert>          // assert
+#include <cstddef>          // std::size_t
+#include <cstdint>          // std::uint32_t
+#include <initializer_list> // std::initializer_list
+#include <iterator>         // std::distance, std::iterator_traits
+#include <memory>           // std::allocator, std::allocator_traits
+#include <utility>          // std::forward, std::move, std::swap
+
+namespace dst
+{
+
+namespace binary_tree
+{
+
+/// @class persistent_list dst/binary_tree/persistent_list.h
+/// Sequence of elements kept in a treap whose nodes are reference counted
+/// and shared between copies. Copying a list or taking a `snapshot()` takes
+/// O(1) time; a modification copies the shared nodes on its path, O(log n)
+/// of them in expectation, and changes the nodes it owns alone in place.
+/// Nodes have no parent links, which is what lets them be shared, so the
+/// elements are addressed by index and iterators are read-only.
+/// A single object must not be used by several threads at once, but the
+/// copies of a list may be used by different threads without locking: the
+/// reference counts are atomic and shared nodes are never modified.
+/// Any copy may free the nodes it was the last to refer to, so copies may
+/// only be used by different threads if the allocator is safe to use from
+/// several threads at once (see `is_thread_safe_allocator`); for example,
+/// `pool_allocator` is not.
+template <typename T, typename Allocator = std::allocator<T>>
+class persistent_list
+{
+private:
+  struct node;
+
+  using node_allocator_type =
+    typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+
+  using node_pointer =
+    typename std::allocator_traits<node_allocator_type>::pointer;
+
+  struct node
+  {
+    template <typename... Args>
+    node(std::uint32_t priority, Args&&... args)
+    : value(std::forward<Args>(args)...)
+    , left(nullptr)
+    , right(nullptr)
+    , size(1)
+    , priority(priority)
+    , references(1)
+    {
+    }
+
+    T value;
+    node_pointer left;
+    node_pointer right;
+    std::size_t size;
+    std::uint32_t priority;
+    std::atomic<std::size_t> references;
+  };
+
+  template <typename U>
+  class iterator_base
+  : public iterator_facade<iterator_base<U>, std::forward_iterator_tag, U>
+  {
+  private:
+    friend iterator_facade<iterator_base<U>, std::forward_iterator_tag, U>;
+
+    friend persistent_list;
+
+    // Enough for the paths of all but astronomically unlikely treaps
+    static constexpr std::size_t path_capacity = 32;
+
+  public:
+    iterator_base()
+    : p_root_(nullptr)
+    , index_(0)
+    , depth_(0)
+    , stored_(0)
+    , path_()
+    {
+    }
+
+    friend bool operator==(const iterator_base& lhs, const iterator_base& rhs)
+    {
+      return lhs.current() == rhs.current();
+    }
+
+  private:
+    explicit iterator_base(node_pointer p_root)
+    : p_root_(p_root)
+    , index_(0)
+    , depth_(0)
+    , stored_(0)
+    , path_()
+    {
+      push_leftmost(p_root);
+    }
+
+    U& value() const
+    {
+      return current()->value;
+    }
+
+    node_pointer current() const
+    {
+      return depth_ == 0 ? node_pointer()
+                         : path_[(depth_ - 1) % path_capacity];
+    }
+
+    void move_forward()
+    {
+      const auto p_node = current();
+
+      --depth_;
+      --stored_;
+      ++index_;
+
+      push_leftmost(p_node->right);
+
+      if (depth_ != 0 && stored_ == 0)
+        reload();
+    }
+
+    void push(node_pointer p_node)
+    {
+      path_[depth_ % path_capacity] = p_node;
+
+      ++depth_;
+
+      if (stored_ < path_capacity)
+        ++stored_;
+    }
+
+    void push_leftmost(node_pointer p_node)
+    {
+      for (; p_node != nullptr; p_node = p_node->left)
+      {
+        push(p_node);
+      }
+    }
+
+    // Rebuilds the path of the element at `index_` from the root, after the
+    // path got deeper than the stored part
+    void reload()
+    {
+      depth_ = 0;
+      stored_ = 0;
+
+      auto k = index_;
+
+      for (auto p_node = p_root_;;)
+      {
+        const auto left_size = size_(p_node->left);
+
+        if (k <= left_size)
+          push(p_node);
+
+        if (k == left_size)
+          return;
+
+        if (k < left_size)
+        {
+          p_node = p_node->left;
+        }
+        else
+        {
+          k -= left_size + 1;
+          p_node = p_node->right;
+        }
+      }
+    }
+
+  private:
+    node_pointer p_root_;
+    std::size_t index_;
+
+    // The ancestors of the current node to be visited, and the node itself.
+    // Only the last `stored_` of the `depth_` nodes are kept, in a ring.
+    std::size_t depth_;
+    std::size_t stored_;
+    std::array<node_pointer, path_capacity> path_;
+  };
+
+public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using size_type = typename std::allocator_traits<Allocator>::size_type;
+  using difference_type =
+    typename std::allocator_traits<Allocator>::difference_type;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+
+  using iterator = iterator_base<const T>;
+  using const_iterator = iterator_base<const T>;
+
+public:
+  persistent_list()
+  : persistent_list(allocator_type())
+  {
+  }
+
+  explicit persistent_list(const allocator_type& allocator)
+  : node_allocator_(allocator)
+  , p_root_(nullptr)
+  {
+  }
+
+  persistent_list(const persistent_list& other)
+  : node_allocator_(other.node_allocator_)
+  , p_root_(retain_(other.p_root_))
+  {
+  }
+
+  persistent_list(persistent_list&& other)
+  : node_allocator_(std::move(other.node_allocator_))
+  , p_root_(other.p_root_)
+  {
+    other.p_root_ = nullptr;
+  }
+
+  template <typename InputIterator,
+            typename = enable_for_input_iterator<InputIterator>>
+  persistent_list(InputIterator from,
+                  InputIterator to,
+                  const allocator_type& allocator = allocator_type())
+  : persistent_list(allocator)
+  {
+    assign_(from,
+            to,
+            typename std::iterator_traits<InputIterator>::iterator_category());
+  }
+
+  persistent_list(const std::initializer_list<value_type>& init,
+                  const allocator_type& allocator = allocator_type())
+  : persistent_list(init.begin(), init.end(), allocator)
+  {
+  }
+
+  ~persistent_list()
+  {
+    release_(p_root_);
+  }
+
+  persistent_list& operator=(persistent_list other)
+  {
+    swap(other);
+
+    return *this;
+  }
+
+  // A read-only copy sharing all the nodes with this list.
+  persistent_list snapshot() const
+  {
+    return *this;
+  }
+
+  allocator_type get_allocator() const
+  {
+    return allocator_type(node_allocator_);
+  }
+
+  size_type size() const
+  {
+    return size_(p_root_);
+  }
+
+  bool empty() const
+  {
+    return p_root_ == nullptr;
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(p_root_);
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator();
+  }
+
+  const_iterator cbegin() const
+  {
+    return begin();
+  }
+
+  const_iterator cend() const
+  {
+    return end();
+  }
+
+  const_reference front() const
+  {
+    return at(0);
+  }
+
+  const_reference back() const
+  {
+    return at(size() - 1);
+  }
+
+  const_reference at(size_type index) const
+  {
+    assert(index < size());
+
+    auto p_node = p_root_;
+
+    for (;;)
+    {
+      const auto left_size = size_(p_node->left);
+
+      if (index == left_size)
+        return p_node->value;
+
+      if (index < left_size)
+      {
+        p_node = p_node->left;
+      }
+      else
+      {
+        index -= left_size + 1;
+        p_node = p_node->right;
+      }
+    }
+  }
+
+  const_reference operator[](size_type index) const
+  {
+    return at(index);
+  }
+
+  template <typename... Args> void emplace(size_type index, Args&&... args)
+  {
+    assert(index <= size());
+
+    const auto p_node =
+      new_node_(detail::random_priority(), std::forward<Args>(args)...);
+
+    try
+    {
+      insert_(p_root_, index, p_node);
+    }
+    catch (...)
+    {
+      delete_node_(p_node);
+      throw;
+    }
+  }
+
+  void insert(size_type index, const_reference v)
+  {
+    emplace(index, v);
+  }
+
+  void insert(size_type index, value_type&& v)
+  {
+    emplace(index, std::move(v));
+  }
+
+  void erase(size_type index)
+  {
+    assert(index < size());
+
+    erase_(p_root_, index);
+  }
+
+  // Replaces the element at `index`.
+  void set(size_type index, value_type v)
+  {
+    assert(index < size());
+
+    auto p_slot = &p_root_;
+
+    for (;;)
+    {
+      unshare_(*p_slot);
+
+      const auto p_node = *p_slot;
+      const auto left_size = size_(p_node->left);
+
+      if (index == left_size)
+      {
+        p_node->value = std::move(v);
+
+        return;
+      }
+
+      if (index < left_size)
+      {
+        p_slot = &p_node->left;
+      }
+      else
+      {
+        index -= left_size + 1;
+        p_slot = &p_node->right;
+      }
+    }
+  }
+
+  template <typename... Args> void emplace_back(Args&&... args)
+  {
+    emplace(size(), std::forward<Args>(args)...);
+  }
+
+  void push_back(const_reference v)
+  {
+    emplace_back(v);
+  }
+
+  void push_back(value_type&& v)
+  {
+    emplace_back(std::move(v));
+  }
+
+  void pop_back()
+  {
+    erase(size() - 1);
+  }
+
+  template <typename... Args> void emplace_front(Args&&... args)
+  {
+    emplace(0, std::forward<Args>(args)...);
+  }
+
+  void push_front(const_reference v)
+  {
+    emplace_front(v);
+  }
+
+  void push_front(value_type&& v)
+  {
+    emplace_front(std::move(v));
+  }
+
+  void pop_front()
+  {
+    erase(0);
+  }
+
+  void clear()
+  {
+    release_(p_root_);
+    p_root_ = nullptr;
+  }
+
+  void swap(persistent_list& other)
+  {
+    using std::swap;
+
+    swap(node_allocator_, other.node_allocator_);
+    swap(p_root_, other.p_root_);
+  }
+
+  friend void swap(persistent_list& lhs, persistent_list& rhs)
+  {
+    lhs.swap(rhs);
+  }
+
+  bool operator==(const persistent_list& other) const
+  {
+    return size() == other.size() &&
+           (p_root_ == other.p_root_ ||
+            std::equal(cbegin(), cend(), other.cbegin()));
+  }
+
+  bool operator!=(const persistent_list& other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  static std::size_t size_(node_pointer p_node)
+  {
+    return p_node == nullptr ? 0 : p_node->size;
+  }
+
+  static void update_size_(node_pointer p_node)
+  {
+    p_node->size = size_(p_node->left) + size_(p_node->right) + 1;
+  }
+
+  static node_pointer retain_(node_pointer p_node)
+  {
+    if (p_node != nullptr)
+      p_node->references.fetch_add(1, std::memory_order_relaxed);
+
+    return p_node;
+  }
+
+  // Drops a reference to the subtree `p_node`, freeing the nodes nobody else
+  // refers to.
+  void release_(node_pointer p_node)
+  {
+    if (p_node == nullptr ||
+        p_node->references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+      return;
+
+    release_(p_node->left);
+    release_(p_node->right);
+
+    delete_node_(p_node);
+  }
+
+  template <typename ForwardIterator>
+  void assign_(ForwardIterator from,
+               ForwardIterator to,
+               std::forward_iterator_tag)
+  {
+    p_root_ = build_(from, static_cast<std::size_t>(std::distance(from, to)));
+  }
+
+  template <typename InputIterator>
+  void assign_(InputIterator from, InputIterator to, std::input_iterator_tag)
+  {
+    for (; from != to; ++from)
+    {
+      push_back(*from);
+    }
+  }
+
+  // Builds a balanced tree of the `n` elements from `from` on, then sifts
+  // the random priorities of each subtree down into heap order. O(n) time.
+  template <typename ForwardIterator>
+  node_pointer build_(ForwardIterator& from, std::size_t n)
+  {
+    if (n == 0)
+      return nullptr;
+
+    const auto p_left = build_(from, n / 2);
+
+    node_pointer p_node;
+
+    try
+    {
+      p_node = new_node_(detail::random_priority(), *from);
+    }
+    catch (...)
+    {
+      release_(p_left);
+      throw;
+    }
+
+    ++from;
+
+    p_node->left = p_left;
+
+    try
+    {
+      p_node->right = build_(from, n - n / 2 - 1);
+    }
+    catch (...)
+    {
+      release_(p_node);
+      throw;
+    }
+
+    p_node->size = n;
+
+    sift_down_(p_node);
+
+    return p_node;
+  }
+
+  static void sift_down_(node_pointer p_node)
+  {
+    for (auto p_child = higher_child_(p_node);
+         p_child != nullptr && p_child->priority > p_node->priority;
+         p_node = p_child, p_child = higher_child_(p_node))
+    {
+      std::swap(p_child->priority, p_node->priority);
+    }
+  }
+
+  static node_pointer higher_child_(node_pointer p_node)
+  {
+    if (p_node->left == nullptr)
+      return p_node->right;
+
+    if (p_node->right == nullptr)
+      return p_node->left;
+
+    return p_node->left->priority > p_node->right->priority ? p_node->left
+                                                            : p_node->right;
+  }
+
+  template <typename... Args>
+  node_pointer new_node_(std::uint32_t priority, Args&&... args)
+  {
+    using traits = std::allocator_traits<node_allocator_type>;
+
+    const auto p_node = traits::allocate(node_allocator_, 1);
+
+    try
+    {
+      traits::construct(node_allocator_,
+                        std::addressof(*p_node),
+                        priority,
+                        std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      traits::deallocate(node_allocator_, p_node, 1);
+      throw;
+    }
+
+    return p_node;
+  }
+
+  void delete_node_(node_pointer p_node)
+  {
+    using traits = std::allocator_traits<node_allocator_type>;
+
+    traits::destroy(node_allocator_, std::addressof(*p_node));
+    traits::deallocate(node_allocator_, p_node, 1);
+  }
+
+  // Makes the node in `p_slot` one that only the caller refers to, copying
+  // it if it is shared. Leaves the tree intact if the copy throws.
+  void unshare_(node_pointer& p_slot)
+  {
+    assert(p_slot != nullptr);
+
+    if (p_slot->references.load(std::memory_order_acquire) == 1)
+      return;
+
+    const auto p_copy = new_node_(p_slot->priority, p_slot->value);
+
+    p_copy->left = retain_(p_slot->left);
+    p_copy->right = retain_(p_slot->right);
+    p_copy->size = p_slot->size;
+
+    release_(p_slot);
+
+    p_slot = p_copy;
+  }
+
+  // $   |            |   $
+  // $   x            y   $
+  // $  / \          / \  $
+  // $ a   y   =>   x   c $
+  // $    / \      / \    $
+  // $   b   c    a   b   $
+  static node_pointer rotate_left_(node_pointer p_x)
+  {
+    const auto p_y = p_x->right;
+
+    p_x->right = p_y->left;
+    p_y->left = p_x;
+
+    update_size_(p_x);
+    update_size_(p_y);
+
+    return p_y;
+  }
+
+  // $     |        |     $
+  // $     x        y     $
+  // $    / \      / \    $
+  // $   y   c => a   x   $
+  // $  / \          / \  $
+  // $ a   b        b   c $
+  static node_pointer rotate_right_(node_pointer p_x)
+  {
+    const auto p_y = p_x->left;
+
+    p_x->left = p_y->right;
+    p_y->right = p_x;
+
+    update_size_(p_x);
+    update_size_(p_y);
+
+    return p_y;
+  }
+
+  // Inserts the detached node `p_x` at position `k` of the subtree in
+  // `p_slot`. Copies the shared nodes on the way down, then rotates `p_x` up
+  // to its place in the heap order.
+  void insert_(node_pointer& p_slot, std::size_t k, node_pointer p_x)
+  {
+    if (p_slot == nullptr)
+    {
+      p_slot = p_x;
+
+      return;
+    }
+
+    unshare_(p_slot);
+
+    const auto p_node = p_slot;
+    const auto left_size = size_(p_node->left);
+
+    if (k <= left_size)
+    {
+      insert_(p_node->left, k, p_x);
+      ++p_node->size;
+
+      if (p_node->left->priority > p_node->priority)
+        p_slot = rotate_right_(p_node);
+    }
+    else
+    {
+      insert_(p_node->right, k - left_size - 1, p_x);
+      ++p_node->size;
+
+      if (p_node->right->priority > p_node->priority)
+        p_slot = rotate_left_(p_node);
+    }
+  }
+
+  void erase_(node_pointer& p_slot, std::size_t k)
+  {
+    unshare_(p_slot);
+
+    const auto p_node = p_slot;
+    const auto left_size = size_(p_node->left);
+
+    if (k == left_size)
+    {
+      erase_root_(p_slot);
+    }
+    else if (k < left_size)
+    {
+      erase_(p_node->left, k);
+      --p_node->size;
+    }
+    else
+    {
+      erase_(p_node->right, k - left_size - 1);
+      --p_node->size;
+    }
+  }
+
+  // Erases the root of the subtree in `p_slot`, which only the caller refers
+  // to, rotating it down until it has at most one child.
+  void erase_root_(node_pointer& p_slot)
+  {
+    const auto p_node = p_slot;
+
+    if (p_node->left == nullptr || p_node->right == nullptr)
+    {
+      p_slot = p_node->left != nullptr ? p_node->left : p_node->right;
+
+      p_node->left = nullptr;
+      p_node->right = nullptr;
+
+      release_(p_node);
+
+      return;
+    }
+
+    if (p_node->left->priority > p_node->right->priority)
+    {
+      unshare_(p_node->left);
+      p_slot = rotate_right_(p_node);
+      erase_root_(p_slot->right);
+    }
+    else
+    {
+      unshare_(p_node->right);
+      p_slot = rotate_left_(p_node);
+      erase_root_(p_slot->left);
+    }
+
+    update_size_(p_slot);
+  }
+
+private:
+  node_allocator_type node_allocator_;
+  node_pointer p_root_;
+};
+
+} // binary_tree
+
+} // dst
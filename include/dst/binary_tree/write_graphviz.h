@@ -8,6 +8,7 @@
 
 #include "iterator_facade.h"
 
+#include <algorithm>
 #include <ostream>
 #include <queue>
 
@@ -200,4 +200,138 @@ private:
   }
 };
 
+template <typename Derived, typename T>
+class iterator_facade<Derived, std::random_access_iterator_tag, T>
+{
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using reference = T&;
+
+public:
+  typename iterator_facade::reference operator*() const
+  {
+    return derived_().value();
+  }
+
+  typename iterator_facade::pointer operator->() const
+  {
+    return std::addressof(derived_().value());
+  }
+
+  typename iterator_facade::reference operator[](difference_type n) const
+  {
+    return *(derived_() + n);
+  }
+
+  Derived& operator++()
+  {
+    derived_().move_forward();
+
+    return derived_();
+  }
+
+  Derived operator++(int)
+  {
+    const auto prev = derived_();
+
+    derived_().move_forward();
+
+    return prev;
+  }
+
+  Derived& operator--()
+  {
+    derived_().move_back();
+
+    return derived_();
+  }
+
+  Derived operator--(int)
+  {
+    const auto prev = derived_();
+
+    derived_().move_back();
+
+    return prev;
+  }
+
+  Derived& operator+=(difference_type n)
+  {
+    derived_().advance(n);
+
+    return derived_();
+  }
+
+  Derived& operator-=(difference_type n)
+  {
+    derived_().advance(-n);
+
+    return derived_();
+  }
+
+  friend Derived operator+(Derived it, difference_type n)
+  {
+    return it += n;
+  }
+
+  friend Derived operator+(difference_type n, Derived it)
+  {
+    return it += n;
+  }
+
+  friend Derived operator-(Derived it, difference_type n)
+  {
+    return it -= n;
+  }
+
+  friend difference_type operator-(const Derived& lhs, const Derived& rhs)
+  {
+    return rhs.distance_to_(lhs);
+  }
+
+  friend bool operator!=(const Derived& lhs, const Derived& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  friend bool operator<(const Derived& lhs, const Derived& rhs)
+  {
+    return lhs.distance_to_(rhs) > 0;
+  }
+
+  friend bool operator>(const Derived& lhs, const Derived& rhs)
+  {
+    return rhs < lhs;
+  }
+
+  friend bool operator<=(const Derived& lhs, const Derived& rhs)
+  {
+    return !(rhs < lhs);
+  }
+
+  friend bool operator>=(const Derived& lhs, const Derived& rhs)
+  {
+    return !(lhs < rhs);
+  }
+
+private:
+  Derived& derived_()
+  {
+    return static_cast<Derived&>(*this);
+  }
+
+  const Derived& derived_() const
+  {
+    return static_cast<const Derived&>(*this);
+  }
+
+  difference_type distance_to_(const Derived& other) const
+  {
+    return derived_().distance_to(other);
+  }
+};
+
 } // dst
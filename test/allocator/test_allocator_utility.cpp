@@ -4,7 +4,10 @@
 //      (See accompanying file LICENSE.txt or copy at
 //          http://www.boost.org/LICENSE_1_0.txt )
 
+#include <dst/allocator/arena_allocator.h>
 #include <dst/allocator/counter_allocator.h>
+#include <dst/allocator/global_counter_allocator.h>
+#include <dst/allocator/pool_allocator.h>
 #include <dst/allocator/utility.h>
 
 #include <boost/test/unit_test.hpp>
@@ -171,4 +174,16 @@ BOOST_AUTO_TEST_CASE(test_throw_in_dtor)
   BOOST_TEST(exception_was_thrown);
 }
 
+BOOST_AUTO_TEST_CASE(test_is_thread_safe_allocator)
+{
+  BOOST_TEST(dst::is_thread_safe_allocator<std::allocator<int>>::value);
+
+  BOOST_TEST(!dst::is_thread_safe_allocator<dst::arena_allocator<int>>::value);
+  BOOST_TEST(!dst::is_thread_safe_allocator<dst::pool_allocator<int>>::value);
+  BOOST_TEST(
+    !dst::is_thread_safe_allocator<dst::counter_allocator<int>>::value);
+  BOOST_TEST(
+    !dst::is_thread_safe_allocator<dst::global_counter_allocator<int>>::value);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,300 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include "../binary_tree/tools/avl_tree_invariant.h"
+#include "../binary_tree/tools/indexing_tree_invariant.h"
+
+#include <dst/allocator/arena_allocator.h>
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm> // std::count, std::equal
+#include <cstdint>   // std::uint32_t
+#include <iterator>  // std::next
+#include <memory>    // std::allocator_traits
+#include <numeric>   // std::iota
+#include <thread>
+#include <utility>   // std::move
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(test_arena_allocator)
+
+namespace
+{
+struct payload
+{
+  std::uint32_t a;
+  std::uint32_t b;
+};
+}
+
+BOOST_AUTO_TEST_CASE(test_pointer_size)
+{
+  BOOST_TEST(sizeof(dst::arena_ptr<payload>) == sizeof(std::uint32_t));
+  BOOST_TEST(sizeof(dst::arena_allocator<payload>::size_type) ==
+             sizeof(std::uint32_t));
+}
+
+BOOST_AUTO_TEST_CASE(test_reuse_of_slots)
+{
+  dst::arena_allocator<payload> allocator;
+
+  const auto p_a = allocator.allocate(1);
+  const auto p_b = allocator.allocate(1);
+
+  BOOST_TEST(!!p_a);
+  BOOST_TEST((p_a != p_b));
+  BOOST_TEST((p_a != nullptr));
+
+  p_a->a = 1;
+  p_b->a = 2;
+
+  BOOST_TEST((*p_a).a == 1);
+  BOOST_TEST(p_b.get()->a == 2);
+
+  allocator.deallocate(p_b, 1);
+
+  const auto p_c = allocator.allocate(1);
+
+  BOOST_TEST((p_c == p_b));
+  BOOST_TEST(p_a->a == 1);
+
+  allocator.deallocate(p_c, 1);
+  allocator.deallocate(p_a, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_references_survive_growth)
+{
+  dst::arena_allocator<payload> allocator;
+
+  std::vector<dst::arena_ptr<payload>> pointers;
+  std::vector<payload*> addresses;
+
+  for (std::uint32_t i = 0; i < 10000; ++i)
+  {
+    pointers.push_back(allocator.allocate(1));
+    pointers.back()->a = i;
+    addresses.push_back(pointers.back().get());
+  }
+
+  for (std::uint32_t i = 0; i < 10000; ++i)
+  {
+    BOOST_TEST(pointers[i].get() == addresses[i]);
+    BOOST_TEST(pointers[i]->a == i);
+  }
+
+  for (const auto& p : pointers)
+  {
+    allocator.deallocate(p, 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_array_allocation)
+{
+  dst::arena_allocator<payload> allocator;
+
+  const auto p_single = allocator.allocate(1);
+  const auto p_array = allocator.allocate(100);
+
+  for (std::uint32_t i = 0; i < 100; ++i)
+  {
+    (p_array.get() + i)->a = i;
+  }
+
+  BOOST_TEST(p_array.get()[99].a == 99);
+  BOOST_TEST((p_single != p_array));
+
+  allocator.deallocate(p_array, 100);
+  allocator.deallocate(p_single, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_rebind)
+{
+  dst::arena_allocator<int> int_allocator;
+
+  std::allocator_traits<dst::arena_allocator<int>>::rebind_alloc<payload>
+    payload_allocator(int_allocator);
+
+  BOOST_TEST((int_allocator == payload_allocator));
+
+  const dst::arena_ptr<const payload> p = payload_allocator.allocate(1);
+
+  BOOST_TEST(!!p);
+
+  payload_allocator.deallocate(
+    dst::arena_ptr<payload>::from_index(p.index()), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_arena_per_allocator)
+{
+  dst::arena_allocator<payload> a;
+  dst::arena_allocator<payload> b;
+
+  const dst::arena_allocator<payload> a_copy(a);
+
+  BOOST_TEST((a != b));
+  BOOST_TEST((a == a_copy));
+
+  const auto p_a = a.allocate(1);
+  const auto p_b = b.allocate(1);
+
+  p_a->a = 1;
+  p_b->a = 2;
+
+  BOOST_TEST((p_a != p_b));
+
+  // Releasing all of `b`'s objects frees its arena, whatever `a` keeps
+  b.deallocate(p_b, 1);
+
+  const auto p_b_again = b.allocate(100);
+
+  BOOST_TEST((p_b_again == p_b));
+  BOOST_TEST(p_a->a == 1);
+
+  // Copies share the arena, so they may free each other's objects
+  const auto p_copy = dst::arena_allocator<payload>(a_copy).allocate(1);
+
+  a.deallocate(p_copy, 1);
+  a.deallocate(p_a, 1);
+  b.deallocate(p_b_again, 100);
+}
+
+BOOST_AUTO_TEST_CASE(test_moved_from_allocator)
+{
+  dst::arena_allocator<payload> allocator;
+
+  const auto p_first = allocator.allocate(1);
+
+  {
+    dst::arena_allocator<payload> moved(std::move(allocator));
+
+    BOOST_TEST((moved == allocator));
+  }
+
+  const auto p_second = allocator.allocate(1);
+  p_second->a = 3;
+
+  BOOST_TEST((p_first != p_second));
+
+  allocator.deallocate(p_second, 1);
+  allocator.deallocate(p_first, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_arena_when_ids_run_out)
+{
+  std::vector<dst::arena_allocator<payload>> allocators(100);
+  std::vector<dst::arena_ptr<payload>> pointers;
+
+  for (std::uint32_t i = 0; i < allocators.size(); ++i)
+  {
+    pointers.push_back(allocators[i].allocate(1));
+    pointers.back()->a = i;
+  }
+
+  for (std::uint32_t i = 0; i < allocators.size(); ++i)
+  {
+    BOOST_TEST(pointers[i]->a == i);
+  }
+
+  for (std::uint32_t i = 0; i < allocators.size(); ++i)
+  {
+    allocators[i].deallocate(pointers[i], 1);
+  }
+
+  // The ids are free again once the allocators are gone
+  allocators.clear();
+
+  dst::arena_allocator<payload> allocator;
+
+  const auto p = allocator.allocate(1);
+
+  BOOST_TEST((p.index() >> 26) != 0u);
+
+  allocator.deallocate(p, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_with_binary_tree_list)
+{
+  using list_type = dst::binary_tree::list<int,
+                                           dst::arena_allocator<int>,
+                                           dst::binary_tree::Indexing,
+                                           dst::binary_tree::AVL>;
+
+  std::vector<int> v(1000);
+  std::iota(v.begin(), v.end(), 0);
+
+  list_type l(v.begin(), v.end());
+
+  for (int i = 0; i < 500; ++i)
+  {
+    l.erase(l.element_at(static_cast<std::size_t>(i)));
+    l.push_back(i);
+  }
+
+  for (int i = 0; i < 500; ++i)
+  {
+    v.erase(v.begin() + i);
+    v.push_back(i);
+  }
+
+  BOOST_TEST(l.size() == v.size());
+  BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+  BOOST_TEST(dst_test::avl_invariant_holds(l));
+  BOOST_TEST(dst_test::indexing_invariant_holds(l));
+
+  auto r = l.split(l.element_at(300));
+
+  BOOST_TEST(l.size() == 300);
+  BOOST_TEST(r.size() == 700);
+
+  l.join(r);
+
+  BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_containers)
+{
+  using list_type = dst::binary_tree::
+    list<int, dst::arena_allocator<int>, dst::binary_tree::AVL>;
+
+  // The arena grows while other threads use the nodes they allocated
+  const list_type kept(5000, 1);
+
+  std::vector<std::thread> threads;
+  std::vector<char> ok(4, 0);
+
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([t, &ok]() {
+      std::vector<int> v(20000);
+      std::iota(v.begin(), v.end(), t);
+
+      bool same = true;
+
+      for (int round = 0; round < 5; ++round)
+      {
+        list_type l(v.begin(), v.end());
+
+        l.erase(l.begin(), std::next(l.begin(), 1000));
+        same = same && std::equal(l.begin(), l.end(), v.begin() + 1000,
+                                  v.end());
+      }
+
+      ok[t] = same;
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  BOOST_TEST(std::count(ok.begin(), ok.end(), 1) == 4);
+  BOOST_TEST(std::count(kept.begin(), kept.end(), 1) == 5000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,212 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include <dst/allocator/counter_allocator.h>
+#include <dst/allocator/pool_allocator.h>
+#include <dst/binary_tree/list.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <list>
+#include <memory>  // std::allocator_traits
+#include <utility> // std::move
+
+BOOST_AUTO_TEST_SUITE(test_pool_allocator)
+
+namespace
+{
+template <typename T>
+using test_allocator = dst::pool_allocator<T, dst::counter_allocator<T>, 4>;
+}
+
+BOOST_AUTO_TEST_CASE(test_reuse_of_blocks)
+{
+  dst::counter_allocator<int> counter;
+  test_allocator<int> allocator(counter);
+
+  BOOST_TEST(counter.allocated() == 0);
+
+  int* const p_a = allocator.allocate(1);
+
+  const std::size_t slab_size = counter.allocated();
+
+  BOOST_TEST(slab_size >= 4 * sizeof(int));
+
+  int* const p_b = allocator.allocate(1);
+
+  BOOST_TEST(p_a != p_b);
+  BOOST_TEST(counter.allocated() == slab_size);
+
+  allocator.deallocate(p_b, 1);
+
+  BOOST_TEST(counter.allocated() == slab_size);
+
+  int* const p_c = allocator.allocate(1);
+
+  BOOST_TEST(p_c == p_b);
+  BOOST_TEST(counter.allocated() == slab_size);
+
+  allocator.deallocate(p_c, 1);
+  allocator.deallocate(p_a, 1);
+
+  BOOST_TEST(counter.allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_slab_growth)
+{
+  dst::counter_allocator<int> counter;
+  test_allocator<int> allocator(counter);
+
+  int* p_ints[9];
+
+  for (auto& p : p_ints)
+    p = allocator.allocate(1);
+
+  const std::size_t allocated = counter.allocated();
+
+  BOOST_TEST(allocated != 0);
+  BOOST_TEST(allocated % 3 == 0);
+
+  for (auto& p : p_ints)
+    allocator.deallocate(p, 1);
+
+  BOOST_TEST(counter.allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_array_allocation)
+{
+  dst::counter_allocator<int> counter;
+  test_allocator<int> allocator(counter);
+
+  int* const p_ints = allocator.allocate(10);
+
+  BOOST_TEST(counter.allocated() == 10 * sizeof(int));
+
+  allocator.deallocate(p_ints, 10);
+
+  BOOST_TEST(counter.allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_rebind)
+{
+  dst::counter_allocator<int> counter;
+  test_allocator<int> int_allocator(counter);
+
+  std::allocator_traits<test_allocator<int>>::rebind_alloc<double>
+    double_allocator(int_allocator);
+
+  BOOST_TEST((double_allocator ==
+              test_allocator<double>::rebind<int>::other(double_allocator)));
+  BOOST_TEST((int_allocator == double_allocator));
+  BOOST_TEST((int_allocator != test_allocator<int>(counter)));
+
+  int* const p_int = int_allocator.allocate(1);
+  double* const p_double = double_allocator.allocate(1);
+
+  BOOST_TEST(static_cast<void*>(p_int) != static_cast<void*>(p_double));
+
+  int_allocator.deallocate(p_int, 1);
+  double_allocator.deallocate(p_double, 1);
+
+  BOOST_TEST(counter.allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_moved_from_allocator)
+{
+  dst::counter_allocator<int> counter;
+  test_allocator<int> allocator(counter);
+
+  {
+    test_allocator<int> moved(std::move(allocator));
+
+    BOOST_TEST((moved == allocator));
+  }
+
+  int* const p_int = allocator.allocate(1);
+  *p_int = 17;
+
+  allocator.deallocate(p_int, 1);
+  allocator.release_free_slabs();
+
+  BOOST_TEST(counter.allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_with_std_list)
+{
+  dst::counter_allocator<int> counter;
+
+  {
+    std::list<int, test_allocator<int>> l(test_allocator<int>{counter});
+
+    l.assign({1, 2, 3, 4, 5, 6, 7, 8, 9, 0});
+
+    BOOST_TEST(counter.allocated() != 0);
+  }
+
+  BOOST_TEST(counter.allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_with_binary_tree_list)
+{
+  dst::counter_allocator<int> counter;
+
+  {
+    dst::binary_tree::list<int, test_allocator<int>> l(
+      test_allocator<int>{counter});
+
+    for (int i = 0; i < 100; ++i)
+      l.push_back(i);
+
+    const std::size_t allocated = counter.allocated();
+
+    BOOST_TEST(allocated != 0);
+
+    for (int i = 0; i < 50; ++i)
+      l.pop_front();
+
+    for (int i = 0; i < 50; ++i)
+      l.push_back(i);
+
+    BOOST_TEST(counter.allocated() == allocated);
+    BOOST_TEST(l.size() == 100);
+  }
+
+  BOOST_TEST(counter.allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_clear_of_binary_tree_list)
+{
+  dst::counter_allocator<int> counter;
+
+  dst::binary_tree::list<int, test_allocator<int>> l(
+    test_allocator<int>{counter});
+
+  const std::size_t empty_list = counter.allocated();
+
+  for (int i = 0; i < 1000; ++i)
+    l.push_back(i);
+
+  BOOST_TEST(counter.allocated() > 100 * empty_list);
+
+  l.clear();
+
+  // Only the slab of the list's sentinel is left
+  BOOST_TEST(counter.allocated() == empty_list);
+
+  for (int i = 0; i < 1000; ++i)
+    l.push_back(i);
+
+  // Erasing elements one by one keeps their blocks for reuse
+  for (int i = 0; i < 1000; ++i)
+    l.pop_back();
+
+  BOOST_TEST(counter.allocated() > 100 * empty_list);
+
+  l.clear();
+
+  BOOST_TEST(counter.allocated() == empty_list);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
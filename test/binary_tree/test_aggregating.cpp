@@ -0,0 +1,252 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include "tools/avl_tree_invariant.h"
+
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/aggregating.h>
+#include <dst/binary_tree/mixin/indexing.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <iterator> // std::next
+#include <limits>   // std::numeric_limits
+#include <numeric>  // std::iota
+#include <random>
+#include <string>
+#include <vector>
+
+namespace dst_test
+{
+
+namespace
+{
+// Not commutative: catches summaries combined in the wrong order.
+class concatenation
+{
+public:
+  using summary_type = std::string;
+
+  static summary_type identity()
+  {
+    return summary_type();
+  }
+
+  static summary_type summarize(char c)
+  {
+    return summary_type(1, c);
+  }
+
+  static summary_type combine(const summary_type& lhs,
+                              const summary_type& rhs)
+  {
+    return lhs + rhs;
+  }
+};
+
+// Weighs a chunk of text by its length.
+class text_length
+{
+public:
+  using summary_type = std::size_t;
+
+  static summary_type identity()
+  {
+    return 0;
+  }
+
+  static summary_type summarize(const std::string& chunk)
+  {
+    return chunk.size();
+  }
+
+  static summary_type combine(summary_type lhs, summary_type rhs)
+  {
+    return lhs + rhs;
+  }
+};
+
+using string_list =
+  dst::binary_tree::list<char,
+                         std::allocator<char>,
+                         dst::binary_tree::Indexing,
+                         dst::binary_tree::Aggregating<concatenation>,
+                         dst::binary_tree::AVL>;
+
+using sum_list = dst::binary_tree::list<
+  long long,
+  std::allocator<long long>,
+  dst::binary_tree::Aggregating<dst::binary_tree::sum_monoid<long long>>,
+  dst::binary_tree::AVL>;
+
+using min_list = dst::binary_tree::list<
+  int,
+  std::allocator<int>,
+  dst::binary_tree::Aggregating<dst::binary_tree::min_monoid<int>>,
+  dst::binary_tree::AVL>;
+
+std::string check_summaries(bool& ok, string_list::const_tree_iterator x)
+{
+  if (!x)
+    return std::string();
+
+  const auto expected =
+    check_summaries(ok, left(x)) + *x + check_summaries(ok, right(x));
+
+  ok = ok && string_list::subtree_summary(x) == expected;
+
+  return expected;
+}
+
+bool aggregating_invariant_holds(const string_list& l)
+{
+  bool ok = true;
+  check_summaries(ok, l.croot());
+
+  return ok;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_binary_tree_aggregating)
+
+BOOST_AUTO_TEST_CASE(test_range_queries)
+{
+  std::mt19937 generator(3);
+
+  string_list l;
+  std::string s;
+
+  for (int i = 0; i < 200; ++i)
+  {
+    const auto c = static_cast<char>('a' + i % 26);
+    const auto index =
+      std::uniform_int_distribution<int>(0, int(s.size()))(generator);
+
+    l.insert(std::next(l.cbegin(), index), c);
+    s.insert(s.begin() + index, c);
+
+    if (i % 3 == 2)
+    {
+      const auto k =
+        std::uniform_int_distribution<int>(0, int(s.size()) - 1)(generator);
+
+      l.erase(std::next(l.cbegin(), k));
+      s.erase(s.begin() + k);
+    }
+  }
+
+  BOOST_TEST(avl_invariant_holds(l));
+  BOOST_TEST(aggregating_invariant_holds(l));
+
+  const auto n = static_cast<int>(s.size());
+
+  for (int i = 0; i <= n; ++i)
+  {
+    BOOST_TEST(l.prefix_query(std::next(l.cbegin(), i)) == s.substr(0, i));
+
+    for (int j = i; j <= n; ++j)
+    {
+      BOOST_TEST(l.range_query(std::next(l.cbegin(), i),
+                               std::next(l.cbegin(), j)) ==
+                 s.substr(i, j - i));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_split_join_and_update)
+{
+  const std::string s = "the quick brown fox jumps over the lazy dog";
+
+  for (int i = 0; i <= int(s.size()); ++i)
+  {
+    string_list l(s.begin(), s.end());
+
+    auto tail = l.split(std::next(l.cbegin(), i));
+
+    BOOST_TEST(aggregating_invariant_holds(l));
+    BOOST_TEST(aggregating_invariant_holds(tail));
+    BOOST_TEST(l.prefix_query(l.cend()) == s.substr(0, i));
+    BOOST_TEST(tail.prefix_query(tail.cend()) == s.substr(i));
+
+    tail.join(l);
+
+    BOOST_TEST(aggregating_invariant_holds(tail));
+    BOOST_TEST(tail.prefix_query(tail.cend()) ==
+               s.substr(i) + s.substr(0, i));
+  }
+
+  string_list l(s.begin(), s.end());
+
+  auto it = l.begin() + 4;
+  *it = 'Q';
+  l.update(it);
+
+  BOOST_TEST(aggregating_invariant_holds(l));
+  BOOST_TEST(l.range_query(l.cbegin() + 4, l.cbegin() + 9) == "Quick");
+}
+
+BOOST_AUTO_TEST_CASE(test_builtin_monoids)
+{
+  std::vector<long long> v(1000);
+  std::iota(v.begin(), v.end(), 1);
+
+  const sum_list sums(v.begin(), v.end());
+
+  BOOST_TEST(sums.prefix_query(sums.cend()) == 500500);
+  BOOST_TEST(sums.range_query(std::next(sums.cbegin(), 10),
+                              std::next(sums.cbegin(), 20)) == 155);
+
+  min_list mins = {5, 3, 8, 1, 9, 7};
+
+  BOOST_TEST(mins.range_query(mins.cbegin(), mins.cend()) == 1);
+  BOOST_TEST(mins.range_query(std::next(mins.cbegin(), 4), mins.cend()) == 7);
+  BOOST_TEST(mins.prefix_query(std::next(mins.cbegin(), 2)) == 3);
+  BOOST_TEST(mins.prefix_query(mins.cbegin()) ==
+             std::numeric_limits<int>::max());
+}
+
+BOOST_AUTO_TEST_CASE(test_search_by_weight)
+{
+  using text_buffer =
+    dst::binary_tree::list<std::string,
+                           std::allocator<std::string>,
+                           dst::binary_tree::Aggregating<text_length>,
+                           dst::binary_tree::AVL>;
+
+  text_buffer b = {"The ", "", "quick ", "brown ", "fox"};
+  const std::string text = "The quick brown fox";
+
+  for (std::size_t offset = 0; offset < text.size(); ++offset)
+  {
+    const auto it = b.element_at_weight(offset);
+
+    BOOST_TEST_REQUIRE((it != b.end()));
+
+    const auto chunk_offset = b.prefix_query(it);
+
+    BOOST_TEST(chunk_offset <= offset);
+    BOOST_TEST(offset < chunk_offset + it->size());
+    BOOST_TEST((*it)[offset - chunk_offset] == text[offset]);
+  }
+
+  BOOST_TEST((b.element_at_weight(text.size()) == b.end()));
+
+  const auto it = b.lower_bound_by_prefix(
+    [](std::size_t length) { return length >= 10; });
+
+  BOOST_TEST(*it == "quick ");
+
+  std::vector<long long> v(100, 2);
+  const sum_list sums(v.begin(), v.end());
+
+  for (long long w = 0; w < 200; ++w)
+  {
+    BOOST_TEST((sums.element_at_weight(w) == std::next(sums.cbegin(), w / 2)));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // dst_test
@@ -0,0 +1,319 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include <dst/allocator/global_counter_allocator.h>
+#include <dst/binary_tree/blocked_list.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <iterator> // std::next, std::prev
+#include <numeric>  // std::iota
+#include <random>
+#include <string>
+#include <utility>  // std::swap
+#include <vector>
+
+namespace dst_test
+{
+
+// Small blocks, so that the tests split and merge them a lot
+using small_blocked_list =
+  dst::binary_tree::blocked_list<int, dst::global_counter_allocator<int>, 8>;
+
+namespace
+{
+std::vector<int> iota_vector(int from, int n)
+{
+  std::vector<int> v(n);
+  std::iota(v.begin(), v.end(), from);
+
+  return v;
+}
+
+template <typename List, typename Vector>
+bool same_contents(const List& l, const Vector& v)
+{
+  if (l.size() != v.size() || !std::equal(l.begin(), l.end(), v.begin()) ||
+      !std::equal(l.rbegin(), l.rend(), v.rbegin()))
+    return false;
+
+  for (std::size_t i = 0; i < v.size(); ++i)
+  {
+    if (l[i] != v[i] || l.index(l.element_at(i)) != i)
+      return false;
+  }
+
+  return l.index(l.end()) == l.size();
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_binary_tree_blocked_list)
+
+BOOST_AUTO_TEST_CASE(test_construction)
+{
+  {
+    const small_blocked_list empty;
+
+    BOOST_TEST(empty.empty());
+    BOOST_TEST(empty.size() == 0);
+    BOOST_TEST((empty.begin() == empty.end()));
+
+    for (int n : {1, 7, 8, 9, 100})
+    {
+      const auto v = iota_vector(0, n);
+      const small_blocked_list l(v.begin(), v.end());
+
+      BOOST_TEST(same_contents(l, v));
+
+      const small_blocked_list copy(l);
+
+      BOOST_TEST((copy == l));
+
+      small_blocked_list moved(std::move(copy));
+
+      BOOST_TEST((moved == l));
+    }
+
+    const small_blocked_list l{1, 2, 3};
+
+    BOOST_TEST(l.front() == 1);
+    BOOST_TEST(l.back() == 3);
+  }
+
+  BOOST_TEST(small_blocked_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_push_and_pop)
+{
+  {
+    small_blocked_list l;
+    std::vector<int> v;
+
+    for (int i = 0; i < 100; ++i)
+    {
+      l.push_back(i);
+      l.push_front(-i);
+      v.push_back(i);
+      v.insert(v.begin(), -i);
+    }
+
+    BOOST_TEST(same_contents(l, v));
+
+    for (int i = 0; i < 60; ++i)
+    {
+      l.pop_back();
+      l.pop_front();
+      v.pop_back();
+      v.erase(v.begin());
+    }
+
+    BOOST_TEST(same_contents(l, v));
+
+    l.clear();
+
+    BOOST_TEST(l.empty());
+  }
+
+  BOOST_TEST(small_blocked_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_random_insert_erase)
+{
+  std::mt19937 generator(17);
+
+  {
+    small_blocked_list l;
+    std::vector<int> v;
+
+    for (int i = 0; i < 5000; ++i)
+    {
+      if (v.size() < 30 || generator() % 10 < 5)
+      {
+        const auto pos = generator() % (v.size() + 1);
+
+        const auto it = l.insert(std::next(l.cbegin(), pos), i);
+        v.insert(v.begin() + pos, i);
+
+        BOOST_TEST_REQUIRE(*it == i);
+        BOOST_TEST_REQUIRE(l.index(it) == pos);
+      }
+      else
+      {
+        const auto pos = generator() % v.size();
+
+        const auto it = l.erase(l.element_at(pos));
+        v.erase(v.begin() + pos);
+
+        BOOST_TEST_REQUIRE(l.index(it) == pos);
+      }
+
+      if (i % 250 == 0)
+        BOOST_TEST_REQUIRE(same_contents(l, v));
+    }
+
+    BOOST_TEST(same_contents(l, v));
+
+    const auto from = v.size() / 4;
+    const auto to = v.size() / 2;
+
+    const auto it = l.erase(l.element_at(from), l.element_at(to));
+    v.erase(v.begin() + from, v.begin() + to);
+
+    BOOST_TEST(l.index(it) == from);
+    BOOST_TEST(same_contents(l, v));
+
+    while (!v.empty())
+    {
+      const auto pos = generator() % v.size();
+
+      l.erase(l.element_at(pos));
+      v.erase(v.begin() + pos);
+    }
+
+    BOOST_TEST(l.empty());
+  }
+
+  BOOST_TEST(small_blocked_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_erase_range)
+{
+  std::mt19937 generator(29);
+
+  {
+    const auto v = iota_vector(0, 300);
+
+    for (int i = 0; i < 500; ++i)
+    {
+      small_blocked_list l(v.begin(), v.end());
+      auto expected = v;
+
+      // Fragments the blocks before erasing a range
+      for (int k = 0; k < 50; ++k)
+      {
+        const auto pos = generator() % expected.size();
+
+        l.erase(l.element_at(pos));
+        expected.erase(expected.begin() + pos);
+      }
+
+      auto from = generator() % (expected.size() + 1);
+      auto to = generator() % (expected.size() + 1);
+
+      if (from > to)
+        std::swap(from, to);
+
+      const auto it = l.erase(std::next(l.cbegin(), from),
+                              std::next(l.cbegin(), to));
+      expected.erase(expected.begin() + from, expected.begin() + to);
+
+      BOOST_TEST_REQUIRE(l.index(it) == from);
+      BOOST_TEST_REQUIRE((it == l.end() || *it == expected[from]));
+      BOOST_TEST_REQUIRE(same_contents(l, expected));
+
+      l.insert(l.cbegin(), -1);
+      expected.insert(expected.begin(), -1);
+
+      BOOST_TEST_REQUIRE(same_contents(l, expected));
+    }
+  }
+
+  BOOST_TEST(small_blocked_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_erase_range_refilling_the_last_block)
+{
+  {
+    dst::binary_tree::blocked_list<int, dst::global_counter_allocator<int>> l;
+    std::vector<int> expected;
+
+    for (int i = 0; i < 65; ++i)
+    {
+      l.push_back(i);
+      expected.push_back(i);
+    }
+
+    for (int i = 0; i < 28; ++i)
+    {
+      l.push_front(-i);
+      expected.insert(expected.begin(), -i);
+    }
+
+    for (int i = 0; i < 13; ++i)
+    {
+      l.pop_back();
+      expected.pop_back();
+    }
+
+    // Blocks of 60 and 20 elements; the rest of the last block takes elements
+    // of the first one
+    const auto it = l.erase(l.element_at(59), l.element_at(70));
+    expected.erase(expected.begin() + 59, expected.begin() + 70);
+
+    BOOST_TEST(l.index(it) == 59);
+    BOOST_TEST(*it == expected[59]);
+    BOOST_TEST(same_contents(l, expected));
+  }
+
+  BOOST_TEST(small_blocked_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_non_trivial_elements)
+{
+  using string_list =
+    dst::binary_tree::blocked_list<std::string, std::allocator<std::string>, 4>;
+
+  string_list l;
+  std::vector<std::string> v;
+
+  for (int i = 0; i < 200; ++i)
+  {
+    const auto s = std::string(40, char('a' + i % 26));
+    const auto pos = std::size_t(i * 7) % (v.size() + 1);
+
+    l.insert(std::next(l.cbegin(), pos), s);
+    v.insert(v.begin() + pos, s);
+  }
+
+  // Emplacing a copy of an element of the same block
+  l.emplace(std::next(l.cbegin(), 1), l.front());
+  v.emplace(v.begin() + 1, v.front());
+
+  BOOST_TEST(same_contents(l, v));
+
+  for (int i = 0; i < 150; ++i)
+  {
+    const auto pos = std::size_t(i * 13) % v.size();
+
+    l.erase(l.element_at(pos));
+    v.erase(v.begin() + pos);
+  }
+
+  BOOST_TEST(same_contents(l, v));
+}
+
+BOOST_AUTO_TEST_CASE(test_self_referencing_insert_into_full_block)
+{
+  using string_list = dst::binary_tree::blocked_list<std::string>;
+
+  string_list l;
+  std::vector<std::string> v;
+
+  for (int i = 0; i < 64; ++i)
+  {
+    l.push_back(std::string(40, char('a' + i % 26)));
+    v.push_back(std::string(40, char('a' + i % 26)));
+  }
+
+  // The block is full, and the split moves out the copied element
+  l.insert(l.cbegin(), l[40]);
+  v.insert(v.begin(), v[40]);
+
+  BOOST_TEST(same_contents(l, v));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // dst_test
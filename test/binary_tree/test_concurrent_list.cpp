@@ -0,0 +1,193 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include <dst/allocator/global_counter_allocator.h>
+#include <dst/binary_tree/concurrent_list.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm> // std::equal
+#include <atomic>
+#include <cstddef> // std::size_t
+#include <thread>
+#include <vector>
+
+namespace dst_test
+{
+
+using counted_concurrent_list =
+  dst::binary_tree::concurrent_list<int, dst::global_counter_allocator<int>>;
+
+namespace
+{
+template <typename Reader>
+bool same_contents(const Reader& r, const std::vector<int>& v)
+{
+  if (r.size() != v.size() || !std::equal(r.begin(), r.end(), v.begin()))
+    return false;
+
+  for (std::size_t i = 0; i < v.size(); ++i)
+  {
+    if (r[i] != v[i])
+      return false;
+  }
+
+  return true;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_binary_tree_concurrent_list)
+
+BOOST_AUTO_TEST_CASE(test_basic_operations)
+{
+  {
+    counted_concurrent_list l;
+
+    BOOST_TEST(l.read().empty());
+
+    l.push_back(2);
+    l.push_front(1);
+    l.insert(2, 3);
+
+    BOOST_TEST(same_contents(l.read(), {1, 2, 3}));
+
+    l.set(1, 20);
+    l.erase(0);
+
+    BOOST_TEST(same_contents(l.read(), {20, 3}));
+
+    l.update([](counted_concurrent_list::list_type& list) {
+      list.push_back(4);
+      list.push_back(5);
+    });
+
+    BOOST_TEST(same_contents(l.read(), {20, 3, 4, 5}));
+    BOOST_TEST(l.read().front() == 20);
+    BOOST_TEST(l.read().back() == 5);
+
+    l.clear();
+
+    BOOST_TEST(l.read().empty());
+  }
+
+  BOOST_TEST(counted_concurrent_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_reclamation_waits_for_readers)
+{
+  {
+    counted_concurrent_list l;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+      l.push_back(i);
+    }
+
+    l.reclaim();
+
+    std::vector<int> v(l.list().begin(), l.list().end());
+
+    const auto before = counted_concurrent_list::allocator_type::allocated();
+
+    {
+      const auto r = l.read();
+
+      for (int i = 0; i < 500; ++i)
+      {
+        l.set(i, -i);
+      }
+
+      // The reader's snapshot and the snapshots after it are kept
+      BOOST_TEST(same_contents(r, v));
+      BOOST_TEST(counted_concurrent_list::allocator_type::allocated() >
+                 before + 400 * sizeof(int));
+    }
+
+    for (int i = 0; i < 500; ++i)
+    {
+      v[i] = -i;
+    }
+
+    l.reclaim();
+
+    BOOST_TEST(same_contents(l.read(), v));
+    BOOST_TEST(counted_concurrent_list::allocator_type::allocated() ==
+               before);
+  }
+
+  BOOST_TEST(counted_concurrent_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_readers_and_writer)
+{
+  // The list holds consecutive numbers at any moment
+  const int window = 1000;
+
+  dst::binary_tree::concurrent_list<int> l;
+
+  std::atomic<bool> done(false);
+  std::atomic<std::size_t> reads(0);
+  std::atomic<std::size_t> failures(0);
+
+  std::vector<std::thread> readers;
+
+  for (int k = 0; k < 4; ++k)
+  {
+    readers.emplace_back([&]() {
+      while (!done.load())
+      {
+        const auto r = l.read();
+
+        if (r.empty())
+          continue;
+
+        int expected = r.front();
+        bool consistent = r.size() <= std::size_t(window);
+
+        for (const auto x : r)
+        {
+          consistent = consistent && x == expected++;
+        }
+
+        const auto middle = r.size() / 2;
+
+        consistent = consistent && r[middle] == r.front() + int(middle);
+
+        if (!consistent)
+          ++failures;
+
+        ++reads;
+      }
+    });
+  }
+
+  for (int i = 0; i < 20000; ++i)
+  {
+    if (l.size() == std::size_t(window))
+    {
+      l.update([i](dst::binary_tree::concurrent_list<int>::list_type& list) {
+        list.pop_front();
+        list.push_back(i);
+      });
+    }
+    else
+    {
+      l.push_back(i);
+    }
+  }
+
+  done = true;
+
+  for (auto& t : readers)
+  {
+    t.join();
+  }
+
+  BOOST_TEST(failures.load() == 0u);
+  BOOST_TEST(reads.load() > 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}
@@ -0,0 +1,133 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include <dst/allocator/global_counter_allocator.h>
+#include <dst/binary_tree/concurrent_set.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <functional> // std::greater
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace dst_test
+{
+
+namespace
+{
+template <typename Set> std::vector<int> keys(const Set& s)
+{
+  std::vector<int> result;
+
+  s.for_each([&result](int key) { result.push_back(key); });
+
+  return result;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_binary_tree_concurrent_set)
+
+BOOST_AUTO_TEST_CASE(test_basic_operations)
+{
+  using counted_set =
+    dst::binary_tree::concurrent_set<int,
+                                     std::greater<int>,
+                                     dst::global_counter_allocator<int>>;
+
+  {
+    counted_set s;
+    std::set<int, std::greater<int>> expected;
+
+    std::mt19937 generator(2);
+
+    for (int i = 0; i < 30000; ++i)
+    {
+      const auto key = std::uniform_int_distribution<int>(0, 20000)(generator);
+
+      if (i % 3 == 2)
+        BOOST_TEST_REQUIRE(s.erase(key) == (expected.erase(key) == 1));
+      else
+        BOOST_TEST_REQUIRE(s.insert(key) == expected.insert(key).second);
+    }
+
+    BOOST_TEST(s.segment_count() > 1u);
+    BOOST_TEST(s.size() == expected.size());
+    BOOST_TEST(keys(s) == std::vector<int>(expected.begin(), expected.end()),
+               boost::test_tools::per_element());
+
+    for (int key = -1; key <= 20001; ++key)
+    {
+      BOOST_TEST_REQUIRE(s.contains(key) == (expected.count(key) == 1));
+    }
+  }
+
+  BOOST_TEST(dst::global_counter_allocator<int>::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_insert_and_erase)
+{
+  // Every thread owns the keys equal to its number modulo `threads`, so
+  // the final contents are known, while the keys of all the threads share
+  // segments
+  const int threads = 8;
+  const int range = 40000;
+
+  dst::binary_tree::concurrent_set<int> s;
+
+  std::vector<std::vector<bool>> owned(threads,
+                                       std::vector<bool>(range / threads));
+  std::atomic<int> failures(0);
+
+  std::vector<std::thread> workers;
+
+  for (int t = 0; t < threads; ++t)
+  {
+    workers.emplace_back([&, t]() {
+      std::mt19937 generator(t);
+      auto& mine = owned[t];
+
+      for (int i = 0; i < 20000; ++i)
+      {
+        const auto k =
+          std::uniform_int_distribution<int>(0, range / threads - 1)(generator);
+        const auto key = k * threads + t;
+
+        const bool changed = i % 4 == 3 ? s.erase(key) : s.insert(key);
+
+        if (changed != (i % 4 == 3 ? mine[k] : !mine[k]))
+          ++failures;
+
+        mine[k] = i % 4 != 3;
+
+        if (s.contains(key) != mine[k])
+          ++failures;
+      }
+    });
+  }
+
+  for (auto& w : workers)
+  {
+    w.join();
+  }
+
+  BOOST_TEST(failures.load() == 0);
+
+  std::vector<int> expected;
+
+  for (int key = 0; key < range; ++key)
+  {
+    if (owned[key % threads][key / threads])
+      expected.push_back(key);
+  }
+
+  BOOST_TEST(s.segment_count() > 1u);
+  BOOST_TEST(keys(s) == expected, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}
@@ -8,15 +8,21 @@
 #include "tools/trees_generator.h"
 
 #include <dst/allocator/global_counter_allocator.h>
+#include <dst/binary_tree/list.h>
 #include <dst/binary_tree/mixin/indexing.h>
+#include <dst/binary_tree/mixin/threading.h>
 #include <dst/binary_tree/tree.h>
 
 #include <boost/test/unit_test.hpp>
 
-#include <cstddef> // std::size_t
+#include <algorithm> // std::lower_bound, std::nth_element
+#include <cstddef>   // std::size_t
 #include <iostream>
 #include <iterator> // std::advance
 #include <numeric>  // std::iota
+#include <random>
+#include <type_traits>
+#include <vector>
 
 namespace dst_test
 {
@@ -75,5 +81,96 @@ BOOST_AUTO_TEST_CASE(test_indexed_tree_rotations)
   }
 }
 
+BOOST_AUTO_TEST_CASE(test_random_access_iterators)
+{
+  using indexed_list = dst::binary_tree::list<int,
+                                              std::allocator<int>,
+                                              dst::binary_tree::Indexing,
+                                              dst::binary_tree::AVL>;
+
+  static_assert(
+    std::is_same<
+      std::iterator_traits<indexed_list::iterator>::iterator_category,
+      std::random_access_iterator_tag>::value,
+    "Indexed list must have random access iterators");
+
+  for (int n = 0; n < 40; ++n)
+  {
+    indexed_list l;
+
+    for (int i = 0; i < n; ++i)
+    {
+      l.push_back(i);
+    }
+
+    const auto first = l.cbegin();
+    const auto last = l.cend();
+
+    BOOST_TEST((last - first) == n);
+
+    for (int i = 0; i <= n; ++i)
+    {
+      const auto it = first + i;
+
+      BOOST_TEST((it == std::next(first, i)));
+      BOOST_TEST((last - i == std::next(first, n - i)));
+      BOOST_TEST((it - first) == i);
+      BOOST_TEST((first - it) == -i);
+
+      if (i < n)
+      {
+        BOOST_TEST(first[i] == i);
+        BOOST_TEST(*it == i);
+      }
+
+      for (int j = 0; j <= n; ++j)
+      {
+        const auto jt = first + j;
+
+        BOOST_TEST((jt - it) == j - i);
+        BOOST_TEST((it + (j - i) == jt));
+        BOOST_TEST((it < jt) == (i < j));
+        BOOST_TEST((it <= jt) == (i <= j));
+        BOOST_TEST((it > jt) == (i > j));
+        BOOST_TEST((it >= jt) == (i >= j));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_algorithms_on_random_access_iterators)
+{
+  using threaded_list = dst::binary_tree::list<int,
+                                               std::allocator<int>,
+                                               dst::binary_tree::Threading,
+                                               dst::binary_tree::Indexing,
+                                               dst::binary_tree::AVL>;
+
+  std::vector<int> v(1000);
+  std::iota(v.begin(), v.end(), 0);
+  std::shuffle(v.begin(), v.end(), std::mt19937(7));
+
+  threaded_list l(v.begin(), v.end());
+
+  std::nth_element(l.begin(), l.begin() + 500, l.end());
+
+  BOOST_TEST(l[500] == 500);
+
+  std::sort(l.begin(), l.end());
+
+  for (int i = 0; i < 1000; i += 37)
+  {
+    const auto it = std::lower_bound(l.cbegin(), l.cend(), i);
+
+    BOOST_TEST((it - l.cbegin()) == i);
+    BOOST_TEST(l.index(it) == static_cast<std::size_t>(i));
+  }
+
+  auto it = l.end();
+  it -= 1000;
+
+  BOOST_TEST((it == l.begin()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }
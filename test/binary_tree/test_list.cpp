@@ -0,0 +1,540 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include "tools/avl_tree_invariant.h"
+#include "tools/indexing_tree_invariant.h"
+#include "tools/marking_tree_invariant.h"
+
+#include <dst/allocator/global_counter_allocator.h>
+#include <dst/allocator/pool_allocator.h>
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+#include <dst/binary_tree/mixin/marking.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <cstddef> // std::size_t
+#include <iterator> // std::istream_iterator
+#include <numeric>  // std::iota
+#include <random>
+#include <sstream>
+#include <stdexcept> // std::runtime_error
+#include <vector>
+
+namespace dst_test
+{
+
+using indexed_list = dst::binary_tree::list<int,
+                                            std::allocator<int>,
+                                            dst::binary_tree::Indexing,
+                                            dst::binary_tree::AVL>;
+
+using marked_list = dst::binary_tree::list<int,
+                                           std::allocator<int>,
+                                           dst::binary_tree::Indexing,
+                                           dst::binary_tree::Marking<>,
+                                           dst::binary_tree::AVL>;
+
+namespace
+{
+template <typename List> bool list_invariants_hold(const List& l)
+{
+  return avl_invariant_holds(l) && indexing_invariant_holds(l) &&
+         l.size() == List::subtree_size(l.croot());
+}
+
+std::vector<int> iota_vector(int from, int n)
+{
+  std::vector<int> v(n);
+  std::iota(v.begin(), v.end(), from);
+
+  return v;
+}
+
+class throwing_copy
+{
+public:
+  static std::atomic<int> copies_left;
+
+  throwing_copy(int v)
+  : value(v)
+  {
+  }
+
+  throwing_copy(const throwing_copy& other)
+  : value(other.value)
+  {
+    if (copies_left-- == 0)
+      throw std::runtime_error("copy");
+  }
+
+  int value;
+};
+
+std::atomic<int> throwing_copy::copies_left(-1);
+
+// Stateful allocator which is as safe for several threads as `std::allocator`
+template <typename T> class tagged_allocator
+{
+public:
+  using value_type = T;
+
+  explicit tagged_allocator(int t = 0)
+  : tag(t)
+  {
+  }
+
+  template <typename U>
+  tagged_allocator(const tagged_allocator<U>& other)
+  : tag(other.tag)
+  {
+  }
+
+  T* allocate(std::size_t n)
+  {
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n)
+  {
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  int tag;
+};
+
+template <typename T, typename U>
+bool operator==(const tagged_allocator<T>& lhs, const tagged_allocator<U>& rhs)
+{
+  return lhs.tag == rhs.tag;
+}
+
+template <typename T, typename U>
+bool operator!=(const tagged_allocator<T>& lhs, const tagged_allocator<U>& rhs)
+{
+  return !(lhs == rhs);
+}
+}
+} // dst_test
+
+namespace dst
+{
+template <typename T>
+struct is_thread_safe_allocator<dst_test::tagged_allocator<T>>
+: std::true_type
+{
+};
+} // dst
+
+namespace dst_test
+{
+
+BOOST_AUTO_TEST_SUITE(test_binary_tree_list)
+
+BOOST_AUTO_TEST_CASE(test_build_from_range)
+{
+  for (int n = 0; n < 100; ++n)
+  {
+    std::vector<int> v(n);
+    std::iota(v.begin(), v.end(), 0);
+
+    const indexed_list l(v.begin(), v.end());
+
+    BOOST_TEST(l.size() == v.size());
+    BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+    BOOST_TEST(avl_invariant_holds(l));
+    BOOST_TEST(indexing_invariant_holds(l));
+
+    for (int i = 0; i < n; ++i)
+    {
+      BOOST_TEST(l[i] == i);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_assign_and_initializer_list)
+{
+  indexed_list l = {1, 2, 3, 4, 5};
+
+  BOOST_TEST(l.size() == 5);
+  BOOST_TEST(avl_invariant_holds(l));
+  BOOST_TEST(indexing_invariant_holds(l));
+
+  const std::vector<int> v = {7, 8, 9};
+
+  l.assign(v.begin(), v.end());
+
+  BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+  BOOST_TEST(avl_invariant_holds(l));
+  BOOST_TEST(indexing_invariant_holds(l));
+}
+
+BOOST_AUTO_TEST_CASE(test_insert_range)
+{
+  indexed_list l;
+
+  const std::vector<int> v = {1, 2, 5, 6};
+  const std::vector<int> w = {3, 4};
+
+  auto it = l.insert(l.cend(), v.begin(), v.end());
+
+  BOOST_TEST((it == l.begin()));
+
+  std::advance(it, 2);
+
+  it = l.insert(it, w.begin(), w.end());
+
+  BOOST_TEST(*it == 3);
+  BOOST_TEST(l.size() == 6);
+  BOOST_TEST((l == indexed_list{1, 2, 3, 4, 5, 6}));
+  BOOST_TEST(avl_invariant_holds(l));
+  BOOST_TEST(indexing_invariant_holds(l));
+}
+
+BOOST_AUTO_TEST_CASE(test_build_from_input_range)
+{
+  std::istringstream is("1 2 3 4 5");
+
+  const indexed_list l{std::istream_iterator<int>(is),
+                       std::istream_iterator<int>()};
+
+  BOOST_TEST((l == indexed_list{1, 2, 3, 4, 5}));
+  BOOST_TEST(avl_invariant_holds(l));
+  BOOST_TEST(indexing_invariant_holds(l));
+}
+
+BOOST_AUTO_TEST_CASE(test_build_exception_safety)
+{
+  using list_type =
+    dst::binary_tree::list<throwing_copy,
+                           dst::global_counter_allocator<throwing_copy>,
+                           dst::binary_tree::Indexing,
+                           dst::binary_tree::AVL>;
+
+  const std::vector<throwing_copy> v(20, throwing_copy(0));
+
+  for (int copies = 0; copies < 20; ++copies)
+  {
+    throwing_copy::copies_left = copies;
+
+    BOOST_CHECK_THROW(list_type(v.begin(), v.end()), std::runtime_error);
+    BOOST_TEST(list_type::allocator_type::allocated() == 0);
+  }
+
+  throwing_copy::copies_left = -1;
+}
+
+BOOST_AUTO_TEST_CASE(test_split_and_join)
+{
+  for (int n = 0; n < 40; ++n)
+  {
+    const auto v = iota_vector(0, n);
+
+    for (int pos = 0; pos <= n; ++pos)
+    {
+      indexed_list l(v.begin(), v.end());
+
+      const auto it = std::next(l.cbegin(), pos);
+      const auto tail_begin = it;
+
+      auto r = l.split(it);
+
+      BOOST_TEST(l.size() == pos);
+      BOOST_TEST(r.size() == n - pos);
+      BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.begin() + pos));
+      BOOST_TEST(std::equal(r.begin(), r.end(), v.begin() + pos, v.end()));
+      BOOST_TEST((pos == n || r.cbegin() == tail_begin));
+      BOOST_TEST(list_invariants_hold(l));
+      BOOST_TEST(list_invariants_hold(r));
+
+      l.join(r);
+
+      BOOST_TEST(r.empty());
+      BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+      BOOST_TEST(list_invariants_hold(l));
+      BOOST_TEST(list_invariants_hold(r));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_splice)
+{
+  for (int n = 0; n < 20; ++n)
+  {
+    for (int m = 0; m < 20; ++m)
+    {
+      for (int pos = 0; pos <= n; ++pos)
+      {
+        auto expected = iota_vector(0, n);
+        const auto inserted = iota_vector(100, m);
+
+        indexed_list l(expected.begin(), expected.end());
+        indexed_list other(inserted.begin(), inserted.end());
+
+        l.splice(std::next(l.cbegin(), pos), other);
+
+        expected.insert(
+          expected.begin() + pos, inserted.begin(), inserted.end());
+
+        BOOST_TEST(other.empty());
+        BOOST_TEST(l.size() == expected.size());
+        BOOST_TEST(
+          std::equal(l.begin(), l.end(), expected.begin(), expected.end()));
+        BOOST_TEST(list_invariants_hold(l));
+        BOOST_TEST(list_invariants_hold(other));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_split_and_join_keep_marks)
+{
+  const auto color = dst::binary_tree::default_marking_color;
+  const auto n = 50;
+  const auto v = iota_vector(0, n);
+
+  for (int pos = 0; pos <= n; ++pos)
+  {
+    marked_list l(v.begin(), v.end());
+
+    for (auto it = l.cbegin(); it != l.cend(); ++it)
+    {
+      if (*it % 3 == 0)
+        l.mark(it);
+    }
+
+    auto r = l.split(std::next(l.cbegin(), pos));
+
+    BOOST_TEST(list_invariants_hold(l));
+    BOOST_TEST(list_invariants_hold(r));
+    BOOST_TEST(marking_invariant_holds(l, color));
+    BOOST_TEST(marking_invariant_holds(r, color));
+
+    for (auto it = r.begin_marked(); it != r.end_marked(); ++it)
+    {
+      BOOST_TEST(*it % 3 == 0);
+      BOOST_TEST(*it >= pos);
+    }
+
+    r.splice(r.cbegin(), l);
+
+    BOOST_TEST(list_invariants_hold(r));
+    BOOST_TEST(marking_invariant_holds(r, color));
+    BOOST_TEST(std::distance(r.begin_marked(), r.end_marked()) == (n + 2) / 3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_erase_range)
+{
+  using plain_list = dst::binary_tree::list<int>;
+
+  for (int n = 0; n < 30; ++n)
+  {
+    const auto v = iota_vector(0, n);
+
+    for (int a = 0; a <= n; ++a)
+    {
+      for (int b = a; b <= n; ++b)
+      {
+        indexed_list l(v.begin(), v.end());
+        plain_list pl(v.begin(), v.end());
+
+        const auto to = std::next(l.cbegin(), b);
+        const auto it = l.erase(std::next(l.cbegin(), a), to);
+
+        pl.erase(std::next(pl.cbegin(), a), std::next(pl.cbegin(), b));
+
+        auto expected = v;
+        expected.erase(expected.begin() + a, expected.begin() + b);
+
+        BOOST_TEST((it == to));
+        BOOST_TEST(l.size() == expected.size());
+        BOOST_TEST(
+          std::equal(l.begin(), l.end(), expected.begin(), expected.end()));
+        BOOST_TEST(pl.size() == expected.size());
+        BOOST_TEST(
+          std::equal(pl.begin(), pl.end(), expected.begin(), expected.end()));
+        BOOST_TEST(list_invariants_hold(l));
+        BOOST_TEST(avl_invariant_holds(pl));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_erase_range_frees_nodes)
+{
+  using list_type = dst::binary_tree::list<int,
+                                           dst::global_counter_allocator<int>,
+                                           dst::binary_tree::Indexing,
+                                           dst::binary_tree::AVL>;
+
+  const auto v = iota_vector(0, 100);
+
+  {
+    list_type l(v.begin(), v.end());
+
+    const auto allocated = list_type::allocator_type::allocated();
+
+    l.erase(l.element_at(10), l.element_at(60));
+
+    // 100 elements and the nil node before, 50 elements and nil after
+    BOOST_TEST(list_type::allocator_type::allocated() * 101 == allocated * 51);
+    BOOST_TEST(l.size() == 50);
+  }
+
+  BOOST_TEST(list_type::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_random_cut_and_paste)
+{
+  std::mt19937 generator(42);
+
+  auto v = iota_vector(0, 1000);
+  indexed_list l(v.begin(), v.end());
+
+  for (int i = 0; i < 200; ++i)
+  {
+    std::uniform_int_distribution<int> distribution(0, int(v.size()));
+
+    auto a = distribution(generator);
+    auto b = distribution(generator);
+
+    if (a > b)
+      std::swap(a, b);
+
+    auto tail = l.split(std::next(l.cbegin(), b));
+    auto middle = l.split(std::next(l.cbegin(), a));
+
+    l.join(tail);
+
+    const auto c =
+      std::uniform_int_distribution<int>(0, int(l.size()))(generator);
+
+    l.splice(std::next(l.cbegin(), c), middle);
+
+    std::vector<int> cut(v.begin() + a, v.begin() + b);
+    v.erase(v.begin() + a, v.begin() + b);
+    v.insert(v.begin() + c, cut.begin(), cut.end());
+
+    BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+  }
+
+  BOOST_TEST(list_invariants_hold(l));
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_copy_and_clear)
+{
+  const auto color = dst::binary_tree::default_marking_color;
+  const auto v = iota_vector(0, 10000);
+
+  marked_list l(v.begin(), v.end());
+
+  for (auto it = l.cbegin(); it != l.cend(); ++it)
+  {
+    if (*it % 3 == 0)
+      l.mark(it);
+  }
+
+  l.set_parallel_policy(dst::binary_tree::parallel_policy(5, 100));
+
+  marked_list copy(l);
+
+  BOOST_TEST(copy.get_parallel_policy().threads() == 5u);
+  BOOST_TEST(copy.size() == v.size());
+  BOOST_TEST(std::equal(copy.begin(), copy.end(), v.begin(), v.end()));
+  BOOST_TEST(list_invariants_hold(copy));
+  BOOST_TEST(marking_invariant_holds(copy, color));
+  BOOST_TEST(std::distance(copy.begin_marked(), copy.end_marked()) ==
+             (v.size() + 2) / 3);
+
+  copy.clear();
+
+  BOOST_TEST(copy.empty());
+  BOOST_TEST(list_invariants_hold(copy));
+
+  copy.push_back(1);
+
+  BOOST_TEST(copy.size() == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_move_to_other_allocator)
+{
+  using list_type = dst::binary_tree::list<int,
+                                           tagged_allocator<int>,
+                                           dst::binary_tree::Indexing,
+                                           dst::binary_tree::AVL>;
+
+  const auto v = iota_vector(0, 5000);
+
+  list_type l(v.begin(), v.end(), tagged_allocator<int>(1));
+
+  l.set_parallel_policy(dst::binary_tree::parallel_policy(3, 10));
+
+  list_type moved(std::move(l), tagged_allocator<int>(2));
+
+  BOOST_TEST(moved.get_allocator().tag == 2);
+  BOOST_TEST(std::equal(moved.begin(), moved.end(), v.begin(), v.end()));
+  BOOST_TEST(list_invariants_hold(moved));
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_policy_with_pool_allocator)
+{
+  using list_type = dst::binary_tree::list<int,
+                                           dst::pool_allocator<int>,
+                                           dst::binary_tree::Indexing,
+                                           dst::binary_tree::AVL>;
+
+  static_assert(
+    !dst::is_thread_safe_allocator<list_type::allocator_type>::value,
+    "Pool allocator must not be thread safe");
+
+  const auto v = iota_vector(0, 5000);
+
+  list_type l(v.begin(), v.end());
+
+  // The pool is not synchronized, so the policy must not take effect
+  l.set_parallel_policy(dst::binary_tree::parallel_policy(4, 1));
+
+  list_type copy(l);
+
+  BOOST_TEST(copy.get_parallel_policy().threads() == 4u);
+  BOOST_TEST(std::equal(copy.begin(), copy.end(), v.begin(), v.end()));
+  BOOST_TEST(list_invariants_hold(copy));
+
+  copy.clear();
+  l.clear();
+
+  BOOST_TEST(copy.empty());
+  BOOST_TEST(l.empty());
+  BOOST_TEST(list_invariants_hold(copy));
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_copy_exception_safety)
+{
+  using list_type = dst::binary_tree::list<throwing_copy,
+                                           std::allocator<throwing_copy>,
+                                           dst::binary_tree::Indexing,
+                                           dst::binary_tree::AVL>;
+
+  const std::vector<throwing_copy> v(1000, throwing_copy(0));
+
+  list_type l(v.begin(), v.end());
+
+  l.set_parallel_policy(dst::binary_tree::parallel_policy(4, 1));
+
+  for (int copies = 0; copies < 1000; copies += 97)
+  {
+    throwing_copy::copies_left = copies;
+
+    BOOST_CHECK_THROW(list_type(l, l.get_allocator()), std::runtime_error);
+  }
+
+  throwing_copy::copies_left = -1;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // dst_test
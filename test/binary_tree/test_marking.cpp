@@ -16,7 +16,11 @@
 #include <cstddef> // std::size_t
 #include <iostream>
 #include <iterator> // std::advance
+#include <memory>   // std::allocator, std::make_shared, std::shared_ptr
+#include <new>      // std::bad_alloc
 #include <numeric>  // std::iota
+#include <random>
+#include <vector>
 
 namespace dst_test
 {
@@ -42,6 +46,62 @@ using rgb_tree = dst::binary_tree::tree<int,
                                         dst::binary_tree::Marking<green_t>,
                                         dst::binary_tree::Marking<blue_t>>;
 
+namespace
+{
+// Counts its calls to `allocate`, which `std::allocator` serves, and throws
+// `std::bad_alloc` from them while `*p_failing` is set
+template <typename T> class allocation_counting_allocator
+{
+public:
+  using value_type = T;
+
+  allocation_counting_allocator()
+  : p_allocations(std::make_shared<std::size_t>(0))
+  , p_failing(std::make_shared<bool>(false))
+  {
+  }
+
+  template <typename U>
+  allocation_counting_allocator(const allocation_counting_allocator<U>& other)
+  : p_allocations(other.p_allocations)
+  , p_failing(other.p_failing)
+  {
+  }
+
+  T* allocate(std::size_t n)
+  {
+    ++*p_allocations;
+
+    if (*p_failing)
+      throw std::bad_alloc();
+
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n)
+  {
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  std::shared_ptr<std::size_t> p_allocations;
+  std::shared_ptr<bool> p_failing;
+};
+
+template <typename T, typename U>
+bool operator==(const allocation_counting_allocator<T>& lhs,
+                const allocation_counting_allocator<U>& rhs)
+{
+  return lhs.p_allocations == rhs.p_allocations;
+}
+
+template <typename T, typename U>
+bool operator!=(const allocation_counting_allocator<T>& lhs,
+                const allocation_counting_allocator<U>& rhs)
+{
+  return !(lhs == rhs);
+}
+}
+
 BOOST_AUTO_TEST_SUITE(test_binary_tree_marking)
 
 BOOST_AUTO_TEST_CASE(test_rgb_tree_rotations)
@@ -128,5 +188,204 @@ BOOST_AUTO_TEST_CASE(test_rgb_tree_rotations)
   BOOST_TEST((std::distance(t.cbegin().base(), t.croot()) + 1) == t.size());
 }
 
+BOOST_AUTO_TEST_CASE(test_bulk_mark_and_unmark)
+{
+  std::mt19937 generator(11);
+
+  rgb_tree t = generate_fibonacci_tree(14);
+
+  std::iota(t.begin(), t.end(), 0);
+
+  const auto n = int(t.size());
+
+  std::vector<bool> red_expected(n);
+  std::vector<bool> green_expected(n);
+
+  for (int round = 0; round < 20; ++round)
+  {
+    // Random nodes, with duplicates, some of them marked already
+    std::vector<rgb_tree::const_iterator> positions;
+    std::size_t changed = 0;
+
+    for (int i = 0; i < 40; ++i)
+    {
+      const auto k = std::uniform_int_distribution<int>(0, n - 1)(generator);
+
+      positions.push_back(std::next(t.cbegin(), k));
+
+      changed += red_expected[k] != (round % 3 != 2);
+      red_expected[k] = round % 3 != 2;
+    }
+
+    if (round % 3 != 2)
+      BOOST_TEST(t.mark(positions.begin(), positions.end(), red) == changed);
+    else
+      BOOST_TEST(t.unmark(positions.begin(), positions.end(), red) == changed);
+
+    auto a = std::uniform_int_distribution<int>(0, n)(generator);
+    auto b = std::uniform_int_distribution<int>(0, n)(generator);
+
+    if (a > b)
+      std::swap(a, b);
+
+    changed = 0;
+
+    for (int k = a; k < b; ++k)
+    {
+      changed += green_expected[k] != (round % 2 == 0);
+      green_expected[k] = round % 2 == 0;
+    }
+
+    const auto from = std::next(t.cbegin(), a);
+    const auto to = std::next(t.cbegin(), b);
+
+    if (round % 2 == 0)
+      BOOST_TEST(t.mark_range(from, to, green) == changed);
+    else
+      BOOST_TEST(t.unmark_range(from, to, green) == changed);
+
+    BOOST_TEST(marking_invariant_holds(t, red));
+    BOOST_TEST(marking_invariant_holds(t, green));
+    BOOST_TEST(marking_invariant_holds(t, blue));
+
+    std::vector<int> red_nodes;
+    std::vector<int> green_nodes;
+
+    for (int k = 0; k < n; ++k)
+    {
+      if (red_expected[k])
+        red_nodes.push_back(k);
+
+      if (green_expected[k])
+        green_nodes.push_back(k);
+    }
+
+    BOOST_TEST(std::vector<int>(t.begin_marked(red), t.end_marked(red)) ==
+                 red_nodes,
+               boost::test_tools::per_element());
+
+    BOOST_TEST(std::vector<int>(t.begin_marked(green), t.end_marked(green)) ==
+                 green_nodes,
+               boost::test_tools::per_element());
+
+    BOOST_TEST(std::vector<int>(t.rbegin_marked(green), t.rend_marked(green)) ==
+                 std::vector<int>(green_nodes.rbegin(), green_nodes.rend()),
+               boost::test_tools::per_element());
+
+    BOOST_TEST((t.begin_marked(blue) == t.end_marked(blue)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_bulk_mark_uses_tree_allocator)
+{
+  using counted_tree =
+    dst::binary_tree::tree<int,
+                           allocation_counting_allocator<int>,
+                           dst::binary_tree::Marking<red_t>>;
+
+  // $      |      $
+  // $      3      $
+  // $    /   \    $
+  // $   2     4   $
+  // $  /       \  $
+  // $ 1         5 $
+  counted_tree t;
+
+  const auto it_3 = t.insert_left(t.nil(), 3);
+  const auto it_2 = t.insert_left(it_3, 2);
+  const auto it_4 = t.insert_right(it_3, 4);
+  t.insert_left(it_2, 1);
+  t.insert_right(it_4, 5);
+
+  const auto& allocations = *t.get_allocator().p_allocations;
+  const auto allocations_before = allocations;
+
+  BOOST_TEST(t.mark_range(t.cbegin(), t.cend(), red) == 5u);
+  BOOST_TEST(allocations > allocations_before);
+
+  const auto allocations_after_mark = allocations;
+
+  const std::vector<counted_tree::const_iterator> positions = {
+    std::next(t.cbegin()), std::next(t.cbegin(), 3)};
+
+  BOOST_TEST(t.unmark(positions.begin(), positions.end(), red) == 2u);
+  BOOST_TEST(allocations > allocations_after_mark);
+
+  BOOST_TEST(marking_invariant_holds(t, red));
+  BOOST_TEST(std::vector<int>(t.begin_marked(red), t.end_marked(red)) ==
+               std::vector<int>({1, 3, 5}),
+             boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(test_bulk_mark_failing_to_allocate)
+{
+  using counted_tree =
+    dst::binary_tree::tree<int,
+                           allocation_counting_allocator<int>,
+                           dst::binary_tree::Marking<red_t>>;
+
+  counted_tree t;
+
+  const auto it_2 = t.insert_left(t.nil(), 2);
+  t.insert_left(it_2, 1);
+  t.insert_right(it_2, 3);
+
+  t.mark(std::next(t.cbegin()), red);
+
+  *t.get_allocator().p_failing = true;
+
+  BOOST_CHECK_THROW(t.mark_range(t.cbegin(), t.cend(), red), std::bad_alloc);
+
+  *t.get_allocator().p_failing = false;
+
+  // No node keeps the bit which it borrows while on the path
+  BOOST_TEST(marking_invariant_holds(t, red));
+  BOOST_TEST(std::vector<int>(t.begin_marked(red), t.end_marked(red)) ==
+               std::vector<int>({2}),
+             boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(test_marked_at_and_marked_index)
+{
+  std::mt19937 generator(3);
+
+  rgb_tree t = generate_fibonacci_tree(12);
+
+  std::iota(t.begin(), t.end(), 0);
+
+  std::vector<int> red_nodes;
+  std::size_t red_before = 0;
+
+  for (auto it = t.cbegin(); it != t.cend(); ++it)
+  {
+    BOOST_TEST(t.marked_index(it, red) == red_before);
+
+    if (std::uniform_int_distribution<int>(0, 2)(generator) == 0)
+    {
+      t.mark(it, red);
+      red_nodes.push_back(*it);
+      ++red_before;
+    }
+  }
+
+  BOOST_TEST(t.marked_index(t.cend(), red) == red_nodes.size());
+  BOOST_TEST(t.marked_index(t.cend(), green) == 0u);
+  BOOST_TEST((t.marked_at(0, green) == t.end_marked(green)));
+
+  const auto& ct = t;
+
+  for (std::size_t k = 0; k < red_nodes.size(); ++k)
+  {
+    const auto it = t.marked_at(k, red);
+
+    BOOST_TEST(*it == red_nodes[k]);
+    BOOST_TEST((ct.marked_at(k, red) == it));
+    BOOST_TEST(t.marked_index(it, red) == k);
+    BOOST_TEST((std::next(t.begin_marked(red), k) == it));
+  }
+
+  BOOST_TEST((t.marked_at(red_nodes.size(), red) == t.end_marked(red)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }
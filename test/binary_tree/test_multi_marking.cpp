@@ -0,0 +1,218 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include "tools/avl_tree_invariant.h"
+#include "tools/marking_tree_invariant.h"
+
+#include <dst/allocator/global_counter_allocator.h>
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+#include <dst/binary_tree/mixin/marking.h>
+#include <dst/binary_tree/mixin/multi_marking.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm> // std::min
+#include <random>
+#include <vector>
+
+namespace dst_test
+{
+
+namespace
+{
+enum red_t
+{
+  red
+};
+
+enum green_t
+{
+  green
+};
+
+enum blue_t
+{
+  blue
+};
+
+using rgb_list =
+  dst::binary_tree::list<int,
+                         std::allocator<int>,
+                         dst::binary_tree::Indexing,
+                         dst::binary_tree::MultiMarking<red_t, green_t, blue_t>,
+                         dst::binary_tree::AVL>;
+
+template <typename List, typename Flag>
+std::vector<int> marked_values(const List& l, Flag f)
+{
+  return std::vector<int>(l.begin_marked(f), l.end_marked(f));
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_binary_tree_multi_marking)
+
+BOOST_AUTO_TEST_CASE(test_random_marks)
+{
+  std::mt19937 generator(5);
+
+  rgb_list l;
+  std::vector<int> v;
+  std::vector<std::vector<bool>> flags(3);
+
+  for (int i = 0; i < 3000; ++i)
+  {
+    const auto n = int(v.size());
+    const auto k = std::uniform_int_distribution<int>(0, n)(generator);
+    const auto op = std::uniform_int_distribution<int>(0, 4)(generator);
+
+    if (op == 0 && n > 0)
+    {
+      const auto j = std::min(k, n - 1);
+
+      l.erase(l.element_at(j));
+      v.erase(v.begin() + j);
+
+      for (auto& f : flags)
+        f.erase(f.begin() + j);
+    }
+    else if (op <= 2 || n == 0)
+    {
+      l.insert(k == n ? l.cend() : l.element_at(k), i);
+      v.insert(v.begin() + k, i);
+
+      for (auto& f : flags)
+        f.insert(f.begin() + k, false);
+    }
+    else
+    {
+      const auto j = std::min(k, n - 1);
+      const auto c = std::uniform_int_distribution<int>(0, 2)(generator);
+      const bool value = op == 3;
+      const auto it = l.element_at(j);
+
+      bool changed = false;
+
+      if (c == 0)
+        changed = value ? l.mark(it, red) : l.unmark(it, red);
+      else if (c == 1)
+        changed = value ? l.mark(it, green) : l.unmark(it, green);
+      else
+        changed = value ? l.mark<blue_t>(it) : l.unmark<blue_t>(it);
+
+      BOOST_TEST(changed == (flags[c][j] != value));
+
+      flags[c][j] = value;
+    }
+  }
+
+  std::vector<std::vector<int>> expected(3);
+
+  for (std::size_t j = 0; j < v.size(); ++j)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      if (flags[c][j])
+        expected[c].push_back(v[j]);
+    }
+  }
+
+  BOOST_TEST(avl_invariant_holds(l));
+  BOOST_TEST(marking_invariant_holds(l, red));
+  BOOST_TEST(marking_invariant_holds(l, green));
+  BOOST_TEST(marking_invariant_holds(l, blue));
+
+  BOOST_TEST(marked_values(l, red) == expected[0],
+             boost::test_tools::per_element());
+  BOOST_TEST(marked_values(l, green) == expected[1],
+             boost::test_tools::per_element());
+  BOOST_TEST(std::vector<int>(l.begin_marked<blue_t>(),
+                              l.end_marked<blue_t>()) == expected[2],
+             boost::test_tools::per_element());
+
+  for (std::size_t k = 0; k < expected[1].size(); ++k)
+  {
+    const auto it = l.marked_at(k, green);
+
+    BOOST_TEST(*it == expected[1][k]);
+    BOOST_TEST(l.marked_index(it.base(), green) == k);
+  }
+
+  BOOST_TEST(l.marked_index<blue_t>(l.cend()) == expected[2].size());
+
+  const auto& cl = l;
+
+  BOOST_TEST(std::vector<int>(cl.rbegin_marked(green), cl.rend_marked(green)) ==
+               std::vector<int>(expected[1].rbegin(), expected[1].rend()),
+             boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(test_split_and_join_keep_marks)
+{
+  rgb_list l;
+
+  for (int i = 0; i < 100; ++i)
+  {
+    const auto it = l.insert(l.cend(), i);
+
+    if (i % 2 == 0)
+      l.mark(it, red);
+
+    if (i % 3 == 0)
+      l.mark(it, blue);
+  }
+
+  auto r = l.split(l.element_at(37));
+
+  BOOST_TEST(marking_invariant_holds(l, red));
+  BOOST_TEST(marking_invariant_holds(r, blue));
+  BOOST_TEST(rgb_list::marked_nodes(l.croot(), red) == 19u);
+  BOOST_TEST(rgb_list::marked_nodes(r.croot(), blue) == 21u);
+  BOOST_TEST((l.begin_marked(green) == l.end_marked(green)));
+
+  l.join(r);
+
+  BOOST_TEST(marking_invariant_holds(l, red));
+  BOOST_TEST(marking_invariant_holds(l, blue));
+  BOOST_TEST(rgb_list::marked_nodes(l.croot(), red) == 50u);
+  BOOST_TEST(rgb_list::marked_nodes(l.croot(), blue) == 34u);
+}
+
+BOOST_AUTO_TEST_CASE(test_smaller_nodes_than_stacked_marking)
+{
+  using stacked_list =
+    dst::binary_tree::list<int,
+                           dst::global_counter_allocator<int>,
+                           dst::binary_tree::Indexing,
+                           dst::binary_tree::Marking<red_t>,
+                           dst::binary_tree::Marking<green_t>,
+                           dst::binary_tree::Marking<blue_t>,
+                           dst::binary_tree::AVL>;
+
+  using multi_list = dst::binary_tree::list<
+    int,
+    dst::global_counter_allocator<int>,
+    dst::binary_tree::Indexing,
+    dst::binary_tree::MultiMarking<red_t, green_t, blue_t>,
+    dst::binary_tree::AVL>;
+
+  std::size_t stacked_bytes = 0;
+  std::size_t multi_bytes = 0;
+
+  {
+    stacked_list l(100, 0);
+    stacked_bytes = stacked_list::allocator_type::allocated();
+  }
+
+  {
+    multi_list l(100, 0);
+    multi_bytes = multi_list::allocator_type::allocated();
+  }
+
+  BOOST_TEST(multi_bytes < stacked_bytes);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}
@@ -9,9 +9,14 @@
 #include <dst/allocator/counter_allocator.h>
 #include <dst/allocator/wary_allocator.h>
 #include <dst/binary_tree/balanced_tree.h>
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
 
 #include <boost/test/unit_test.hpp>
 
+#include <random>
+#include <vector>
+
 namespace dst_test
 {
 
@@ -28,9 +33,27 @@ using ordering_tree =
                                   dst::binary_tree::AVL,
                                   dst::binary_tree::Ordering>;
 
+using order_maintenance_list =
+  dst::binary_tree::list<int,
+                         test_allocator<int>,
+                         dst::binary_tree::Indexing,
+                         dst::binary_tree::AVL,
+                         dst::binary_tree::OrderMaintenance>;
+
+template <typename List> bool order_matches_index(const List& l)
+{
+  for (auto it = l.cbegin(); it != l.cend(); ++it)
+  {
+    if (!l.order(it, std::next(it)) || l.order(std::next(it), it))
+      return false;
+  }
+
+  return !l.order(l.cend(), l.cbegin()) || l.empty();
+}
+
 BOOST_AUTO_TEST_SUITE(test_binary_tree_ordering)
 
-BOOST_AUTO_TEST_CASE(test_allocator_used_by_internal_vectors)
+BOOST_AUTO_TEST_CASE(test_order_does_not_allocate)
 {
   // $      |      $
   // $      3      $
@@ -46,25 +69,167 @@ BOOST_AUTO_TEST_CASE(test_allocator_used_by_internal_vectors)
   const auto it_1 = tree.insert_left(it_2, 1);
   const auto it_5 = tree.insert_right(it_4, 5);
 
-  const auto allocated_memory_1 = tree.get_allocator().allocated();
+  const auto allocated_memory = tree.get_allocator().allocated();
 
-  BOOST_TEST(allocated_memory_1 > 0u);
+  BOOST_TEST(allocated_memory > 0u);
 
   BOOST_TEST(tree.order(it_2, it_4));
+  BOOST_TEST(!tree.order(it_5, it_1));
+  BOOST_TEST(tree.order(it_2, it_5));
+  BOOST_TEST(tree.order(it_1, it_2));
+  BOOST_TEST(!tree.order(it_3, it_2));
+  BOOST_TEST(tree.order(it_3, it_5));
+  BOOST_TEST(!tree.order(it_5, it_4));
+  BOOST_TEST(tree.order(it_5, tree.nil()));
+  BOOST_TEST(!tree.order(tree.nil(), it_1));
+  BOOST_TEST(!tree.order(it_3, it_3));
+
+  BOOST_TEST(tree.get_allocator().allocated() == allocated_memory);
+}
 
-  const auto allocated_memory_2 = tree.get_allocator().allocated();
+BOOST_AUTO_TEST_CASE(test_order_agrees_with_index)
+{
+  using ordered_list = dst::binary_tree::list<int,
+                                              std::allocator<int>,
+                                              dst::binary_tree::Indexing,
+                                              dst::binary_tree::AVL,
+                                              dst::binary_tree::Ordering>;
 
-  BOOST_TEST(allocated_memory_2 > allocated_memory_1);
+  std::mt19937 generator(13);
 
-  BOOST_TEST(!tree.order(it_5, it_1));
+  ordered_list l;
 
-  const auto allocated_memory_3 = tree.get_allocator().allocated();
+  for (int i = 0; i < 1000; ++i)
+  {
+    const auto k =
+      std::uniform_int_distribution<std::size_t>(0, l.size())(generator);
 
-  BOOST_TEST(allocated_memory_3 > allocated_memory_2);
+    l.insert(l.cbegin() + k, i);
+  }
 
-  BOOST_TEST(tree.order(it_2, it_5));
+  BOOST_TEST(order_matches_index(l));
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    const auto a = std::uniform_int_distribution<int>(0, 1000)(generator);
+    const auto b = std::uniform_int_distribution<int>(0, 1000)(generator);
+
+    BOOST_TEST(l.order(l.cbegin() + a, l.cbegin() + b) == (a < b));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_order_maintenance)
+{
+  std::mt19937 generator(7);
+
+  order_maintenance_list l;
+
+  // Inserting again and again at the same place uses up the labels there
+  const auto hot = l.insert(l.cend(), -1);
+
+  for (int i = 0; i < 5000; ++i)
+  {
+    const auto n = int(l.size());
+    const auto op = std::uniform_int_distribution<int>(0, 5)(generator);
+
+    if (op == 0)
+    {
+      l.insert(l.cbegin(), i);
+    }
+    else if (op == 1)
+    {
+      l.insert(hot, i);
+    }
+    else if (op == 2)
+    {
+      l.insert(std::next(hot), i);
+    }
+    else if (op == 3 && n > 1)
+    {
+      const auto k = std::uniform_int_distribution<int>(0, n - 1)(generator);
+
+      if (l.element_at(k) != hot)
+        l.erase(l.element_at(k));
+    }
+    else
+    {
+      const auto k = std::uniform_int_distribution<int>(0, n)(generator);
+
+      l.insert(l.cbegin() + k, i);
+    }
+  }
+
+  BOOST_TEST(order_matches_index(l));
+
+  const auto allocated = l.get_allocator().allocated();
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    const auto n = int(l.size());
+    const auto a = std::uniform_int_distribution<int>(0, n)(generator);
+    const auto b = std::uniform_int_distribution<int>(0, n)(generator);
+
+    BOOST_TEST(l.order(l.cbegin() + a, l.cbegin() + b) == (a < b));
+  }
+
+  BOOST_TEST(l.get_allocator().allocated() == allocated);
+
+  // The halves of a split keep valid labels, a splice relabels
+  auto r = l.split(l.cbegin() + l.size() / 3);
+
+  BOOST_TEST(order_matches_index(l));
+  BOOST_TEST(order_matches_index(r));
+
+  l.splice(l.cbegin() + l.size() / 2, r);
+
+  BOOST_TEST(order_matches_index(l));
+
+  order_maintenance_list c(l, l.get_allocator());
+
+  BOOST_TEST(order_matches_index(c));
+
+  const order_maintenance_list built(100, 0);
+
+  BOOST_TEST(order_matches_index(built));
+}
+
+BOOST_AUTO_TEST_CASE(test_order_maintenance_splice)
+{
+  std::mt19937 generator(11);
+
+  order_maintenance_list l(1000, 0);
+
+  for (int i = 0; i < 300; ++i)
+  {
+    const auto n = int(l.size());
+    const auto k = std::uniform_int_distribution<int>(0, n)(generator);
+    const auto m = std::uniform_int_distribution<int>(0, 40)(generator);
+
+    if (i % 2 == 0)
+    {
+      order_maintenance_list other(std::size_t(m), i, l.get_allocator());
+
+      l.splice(l.cbegin() + k, other);
+    }
+    else
+    {
+      const std::vector<int> v(std::size_t(m), i);
+
+      l.insert(l.cbegin() + k, v.begin(), v.end());
+    }
+
+    BOOST_TEST_REQUIRE(order_matches_index(l));
+  }
+
+  // Splicing many nodes into one spot runs out of labels there
+  for (int i = 0; i < 30; ++i)
+  {
+    order_maintenance_list other(1000, i, l.get_allocator());
+
+    l.splice(l.cbegin() + 1, other);
 
-  BOOST_TEST(tree.get_allocator().allocated() == allocated_memory_3);
+    BOOST_TEST_REQUIRE(order_matches_index(l));
+  }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,176 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+#include <dst/binary_tree/mixin/splay.h>
+#include <dst/binary_tree/parallel_algorithm.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <cstddef> // std::size_t
+#include <numeric> // std::accumulate, std::iota
+#include <string>
+#include <vector>
+
+namespace dst_test
+{
+
+using indexed_list = dst::binary_tree::list<int,
+                                            std::allocator<int>,
+                                            dst::binary_tree::Indexing,
+                                            dst::binary_tree::AVL>;
+
+using avl_list = dst::binary_tree::list<int>;
+
+using indexed_string_list =
+  dst::binary_tree::list<std::string,
+                         std::allocator<std::string>,
+                         dst::binary_tree::Indexing,
+                         dst::binary_tree::AVL>;
+
+using avl_string_list = dst::binary_tree::list<std::string>;
+
+using splay_list = dst::binary_tree::list<int,
+                                          std::allocator<int>,
+                                          dst::binary_tree::Indexing,
+                                          dst::binary_tree::Splay>;
+
+namespace
+{
+std::vector<int> iota_vector(int first, int n)
+{
+  std::vector<int> result(n);
+
+  std::iota(result.begin(), result.end(), first);
+
+  return result;
+}
+
+template <typename List> void check_parallel_for_each()
+{
+  for (const int n : {0, 1, 2, 3, 100, 5000})
+  {
+    const auto v = iota_vector(0, n);
+
+    List l(v.begin(), v.end());
+
+    dst::binary_tree::parallel_for_each(
+      l, [](int& x) { x *= 2; }, dst::binary_tree::parallel_policy(7, 0));
+
+    std::atomic<long long> sum(0);
+
+    dst::binary_tree::parallel_for_each(
+      static_cast<const List&>(l),
+      [&sum](int x) { sum += x; },
+      dst::binary_tree::parallel_policy(3, 0));
+
+    BOOST_TEST(sum.load() == 1ll * n * (n - 1));
+    BOOST_TEST_REQUIRE(l.size() == v.size());
+
+    auto it = l.begin();
+
+    for (const auto x : v)
+    {
+      BOOST_TEST_REQUIRE(*it++ == 2 * x);
+    }
+  }
+}
+
+template <typename List> void check_parallel_reduce_keeps_order()
+{
+  // Concatenation is associative, but not commutative
+  const auto op = [](std::string lhs, const std::string& rhs) {
+    return lhs += rhs;
+  };
+
+  for (const int n : {0, 1, 2, 3, 100, 5000})
+  {
+    std::vector<std::string> v;
+
+    for (int i = 0; i < n; ++i)
+    {
+      v.push_back(std::to_string(i) + ' ');
+    }
+
+    const List l(v.begin(), v.end());
+
+    const auto expected =
+      std::accumulate(v.begin(), v.end(), std::string("> "), op);
+
+    for (const unsigned threads : {1u, 2u, 3u, 8u})
+    {
+      BOOST_TEST(dst::binary_tree::parallel_reduce(
+                   l,
+                   std::string("> "),
+                   op,
+                   dst::binary_tree::parallel_policy(threads, 0)) == expected);
+    }
+  }
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_binary_tree_parallel_algorithm)
+
+BOOST_AUTO_TEST_CASE(test_parallel_for_each)
+{
+  check_parallel_for_each<indexed_list>();
+  check_parallel_for_each<avl_list>();
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_reduce_keeps_order)
+{
+  check_parallel_reduce_keeps_order<indexed_string_list>();
+  check_parallel_reduce_keeps_order<avl_string_list>();
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_reduce_with_tree_policy)
+{
+  const auto v = iota_vector(1, 10000);
+
+  indexed_list l(v.begin(), v.end());
+
+  l.set_parallel_policy(dst::binary_tree::parallel_policy(4, 100));
+
+  const auto sum = dst::binary_tree::parallel_reduce(
+    l, 0ll, [](long long lhs, long long rhs) { return lhs + rhs; });
+
+  BOOST_TEST(sum == std::accumulate(v.begin(), v.end(), 0ll));
+}
+
+BOOST_AUTO_TEST_CASE(test_degenerate_tree)
+{
+  const auto v = iota_vector(0, 100000);
+
+  splay_list l(v.begin(), v.end());
+
+  // Splaying every element in order leaves a path
+  for (std::size_t i = 0; i < l.size(); ++i)
+  {
+    l.at(i);
+  }
+
+  const auto plus = [](long lhs, long rhs) { return lhs + rhs; };
+  const auto expected = std::accumulate(v.begin(), v.end(), 0l);
+
+  for (const unsigned threads : {2u, 4u})
+  {
+    const dst::binary_tree::parallel_policy policy(threads, 0);
+
+    BOOST_TEST(dst::binary_tree::parallel_reduce(l, 0l, plus, policy) ==
+               expected);
+
+    std::atomic<long> sum(0);
+
+    dst::binary_tree::parallel_for_each(
+      l, [&sum](int x) { sum += x; }, policy);
+
+    BOOST_TEST(sum.load() == expected);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}
@@ -0,0 +1,253 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include <dst/allocator/global_counter_allocator.h>
+#include <dst/binary_tree/persistent_list.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>  // std::size_t
+#include <iterator> // std::istream_iterator
+#include <numeric>  // std::iota, std::accumulate
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace dst_test
+{
+
+using counted_persistent_list =
+  dst::binary_tree::persistent_list<int, dst::global_counter_allocator<int>>;
+
+namespace
+{
+template <typename List>
+bool same_contents(const List& l, const std::vector<int>& v)
+{
+  if (l.size() != v.size() || !std::equal(l.begin(), l.end(), v.begin()))
+    return false;
+
+  for (std::size_t i = 0; i < v.size(); ++i)
+  {
+    if (l[i] != v[i])
+      return false;
+  }
+
+  return true;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_binary_tree_persistent_list)
+
+BOOST_AUTO_TEST_CASE(test_basic_operations)
+{
+  {
+    counted_persistent_list l{1, 2, 3};
+
+    BOOST_TEST(same_contents(l, {1, 2, 3}));
+
+    l.push_front(0);
+    l.push_back(4);
+    l.insert(2, 10);
+
+    BOOST_TEST(same_contents(l, {0, 1, 10, 2, 3, 4}));
+
+    l.erase(2);
+    l.pop_front();
+    l.pop_back();
+    l.set(1, 20);
+
+    BOOST_TEST(same_contents(l, {1, 20, 3}));
+    BOOST_TEST(l.front() == 1);
+    BOOST_TEST(l.back() == 3);
+
+    l.clear();
+
+    BOOST_TEST(l.empty());
+    BOOST_TEST((l.begin() == l.end()));
+  }
+
+  BOOST_TEST(counted_persistent_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_build_from_ranges)
+{
+  {
+    for (int n = 0; n < 100; ++n)
+    {
+      std::vector<int> v(n);
+      std::iota(v.begin(), v.end(), 0);
+
+      counted_persistent_list l(v.begin(), v.end());
+
+      BOOST_TEST_REQUIRE(same_contents(l, v));
+
+      l.insert(std::size_t(n / 2), -1);
+      v.insert(v.begin() + n / 2, -1);
+
+      BOOST_TEST_REQUIRE(same_contents(l, v));
+    }
+
+    std::istringstream input("1 2 3 4 5");
+
+    const counted_persistent_list l(std::istream_iterator<int>(input),
+                                    std::istream_iterator<int>{});
+
+    BOOST_TEST(same_contents(l, {1, 2, 3, 4, 5}));
+  }
+
+  BOOST_TEST(counted_persistent_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_snapshots_stay_unchanged)
+{
+  std::mt19937 generator(19);
+
+  {
+    counted_persistent_list l;
+    std::vector<int> v;
+
+    std::vector<counted_persistent_list> snapshots;
+    std::vector<std::vector<int>> expected;
+
+    for (int i = 0; i < 4000; ++i)
+    {
+      const auto op = generator() % 10;
+
+      if (v.size() < 20 || op < 5)
+      {
+        const auto pos = generator() % (v.size() + 1);
+
+        l.insert(pos, i);
+        v.insert(v.begin() + pos, i);
+      }
+      else if (op < 8)
+      {
+        const auto pos = generator() % v.size();
+
+        l.erase(pos);
+        v.erase(v.begin() + pos);
+      }
+      else
+      {
+        const auto pos = generator() % v.size();
+
+        l.set(pos, -i);
+        v[pos] = -i;
+      }
+
+      if (i % 200 == 0)
+      {
+        snapshots.push_back(l.snapshot());
+        expected.push_back(v);
+      }
+
+      if (i % 500 == 0)
+        BOOST_TEST_REQUIRE(same_contents(l, v));
+    }
+
+    BOOST_TEST(same_contents(l, v));
+
+    for (std::size_t k = 0; k < snapshots.size(); ++k)
+    {
+      BOOST_TEST(same_contents(snapshots[k], expected[k]));
+    }
+
+    while (!v.empty())
+    {
+      const auto pos = generator() % v.size();
+
+      l.erase(pos);
+      v.erase(v.begin() + pos);
+    }
+
+    BOOST_TEST(l.empty());
+    BOOST_TEST(same_contents(snapshots.back(), expected.back()));
+  }
+
+  BOOST_TEST(counted_persistent_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_modification_copies_a_path)
+{
+  std::vector<int> v(100000);
+  std::iota(v.begin(), v.end(), 0);
+
+  counted_persistent_list l(v.begin(), v.end());
+
+  const auto before = counted_persistent_list::allocator_type::allocated();
+  const auto node_size = before / v.size();
+
+  // Without snapshots the nodes are modified in place
+  l.set(500, -1);
+  l.insert(700, -2);
+  l.erase(900);
+
+  BOOST_TEST(counted_persistent_list::allocator_type::allocated() == before);
+
+  const auto snapshot = l.snapshot();
+
+  BOOST_TEST(counted_persistent_list::allocator_type::allocated() == before);
+
+  l.set(50000, -3);
+  l.insert(60000, -4);
+  l.erase(70000);
+
+  // Far fewer than the 100000 nodes a deep copy would take
+  BOOST_TEST(counted_persistent_list::allocator_type::allocated() <
+             before + 300 * node_size);
+
+  BOOST_TEST(snapshot[50000] == 50000);
+  BOOST_TEST(l[50000] == -3);
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_readers)
+{
+  std::vector<int> v(10000);
+  std::iota(v.begin(), v.end(), 0);
+
+  dst::binary_tree::persistent_list<int> l(v.begin(), v.end());
+
+  const auto expected = std::accumulate(v.begin(), v.end(), 0L);
+
+  std::vector<std::thread> readers;
+  std::vector<long> sums(4);
+
+  for (std::size_t k = 0; k < sums.size(); ++k)
+  {
+    readers.emplace_back(
+      [&sums, k](dst::binary_tree::persistent_list<int> snapshot) {
+        for (int i = 0; i < 20; ++i)
+        {
+          sums[k] = std::accumulate(snapshot.begin(), snapshot.end(), 0L);
+        }
+      },
+      l.snapshot());
+  }
+
+  for (int i = 0; i < 10000; ++i)
+  {
+    l.set(std::size_t(i), -i);
+    l.push_back(i);
+    l.pop_front();
+  }
+
+  for (auto& reader : readers)
+  {
+    reader.join();
+  }
+
+  for (const auto sum : sums)
+  {
+    BOOST_TEST(sum == expected);
+  }
+
+  BOOST_TEST(l.size() == v.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // dst_test
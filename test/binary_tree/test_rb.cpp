@@ -0,0 +1,145 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include "tools/indexing_tree_invariant.h"
+#include "tools/marking_tree_invariant.h"
+#include "tools/rb_tree_invariant.h"
+
+#include <dst/allocator/global_counter_allocator.h>
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+#include <dst/binary_tree/mixin/marking.h>
+#include <dst/binary_tree/mixin/ordering.h>
+#include <dst/binary_tree/mixin/rb.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <numeric> // std::iota
+#include <random>
+#include <vector>
+
+namespace dst_test
+{
+
+using rb_list = dst::binary_tree::list<int,
+                                       dst::global_counter_allocator<int>,
+                                       dst::binary_tree::Indexing,
+                                       dst::binary_tree::RB>;
+
+BOOST_AUTO_TEST_SUITE(test_binary_tree_rb)
+
+BOOST_AUTO_TEST_CASE(test_build)
+{
+  for (int n = 0; n < 100; ++n)
+  {
+    std::vector<int> v(n);
+    std::iota(v.begin(), v.end(), 0);
+
+    const rb_list l(v.begin(), v.end());
+
+    BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+    BOOST_TEST(rb_invariant_holds(l));
+    BOOST_TEST(indexing_invariant_holds(l));
+  }
+
+  BOOST_TEST(rb_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_random_insert_erase)
+{
+  std::mt19937 generator(7);
+
+  {
+    rb_list l;
+    std::vector<int> v;
+
+    for (int i = 0; i < 3000; ++i)
+    {
+      const bool inserting = v.size() < 50 || generator() % 10 < 6;
+
+      if (inserting)
+      {
+        const auto pos = generator() % (v.size() + 1);
+
+        l.insert(std::next(l.cbegin(), pos), i);
+        v.insert(v.begin() + pos, i);
+      }
+      else
+      {
+        const auto pos = generator() % v.size();
+
+        l.erase(l.element_at(pos));
+        v.erase(v.begin() + pos);
+      }
+
+      if (i % 100 == 0)
+      {
+        BOOST_TEST_REQUIRE(rb_invariant_holds(l));
+        BOOST_TEST_REQUIRE(indexing_invariant_holds(l));
+      }
+    }
+
+    BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+    BOOST_TEST(rb_invariant_holds(l));
+
+    while (!l.empty())
+    {
+      l.erase(l.element_at(l.size() / 2));
+
+      BOOST_TEST_REQUIRE(rb_invariant_holds(l));
+    }
+  }
+
+  BOOST_TEST(rb_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_composition_with_marking_and_ordering)
+{
+  using list_type = dst::binary_tree::list<int,
+                                           std::allocator<int>,
+                                           dst::binary_tree::Indexing,
+                                           dst::binary_tree::Marking<>,
+                                           dst::binary_tree::RB,
+                                           dst::binary_tree::Ordering>;
+
+  const auto color = dst::binary_tree::default_marking_color;
+
+  list_type l;
+
+  for (int i = 0; i < 200; ++i)
+  {
+    l.insert(std::next(l.cbegin(), (i * 7) % (l.size() + 1)), i);
+  }
+
+  for (auto it = l.cbegin(); it != l.cend(); ++it)
+  {
+    if (*it % 3 == 0)
+      l.mark(it);
+  }
+
+  for (int i = 0; i < 100; ++i)
+  {
+    l.erase(l.element_at((i * 13) % l.size()));
+  }
+
+  BOOST_TEST(rb_invariant_holds(l));
+  BOOST_TEST(indexing_invariant_holds(l));
+  BOOST_TEST(marking_invariant_holds(l, color));
+
+  for (auto it = l.begin_marked(); it != l.end_marked(); ++it)
+  {
+    BOOST_TEST(*it % 3 == 0);
+  }
+
+  for (std::size_t i = 1; i < l.size(); ++i)
+  {
+    BOOST_TEST(l.order(l.element_at(i - 1).base(), l.element_at(i).base()));
+    BOOST_TEST(!l.order(l.element_at(i).base(), l.element_at(i - 1).base()));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // dst_test
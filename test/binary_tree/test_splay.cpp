@@ -0,0 +1,164 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include "tools/indexing_tree_invariant.h"
+#include "tools/marking_tree_invariant.h"
+
+#include <dst/allocator/global_counter_allocator.h>
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+#include <dst/binary_tree/mixin/marking.h>
+#include <dst/binary_tree/mixin/splay.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <numeric> // std::iota
+#include <random>
+#include <vector>
+
+namespace dst_test
+{
+
+using splay_list = dst::binary_tree::list<int,
+                                          dst::global_counter_allocator<int>,
+                                          dst::binary_tree::Indexing,
+                                          dst::binary_tree::Marking<>,
+                                          dst::binary_tree::Splay>;
+
+BOOST_AUTO_TEST_SUITE(test_binary_tree_splay)
+
+BOOST_AUTO_TEST_CASE(test_access_moves_element_to_root)
+{
+  std::vector<int> v(100);
+  std::iota(v.begin(), v.end(), 0);
+
+  splay_list l(v.begin(), v.end());
+
+  for (std::size_t i : {17u, 18u, 99u, 0u, 50u})
+  {
+    const auto it = l.element_at(i);
+
+    BOOST_TEST((it.base() == l.croot()));
+    BOOST_TEST(*it == int(i));
+  }
+
+  const auto root = l.croot();
+  const splay_list& cl = l;
+
+  BOOST_TEST(cl[3] == 3);
+  BOOST_TEST((l.croot() == root));
+
+  BOOST_TEST(l[3] == 3);
+  BOOST_TEST(*l.croot() == 3);
+  BOOST_TEST(indexing_invariant_holds(l));
+}
+
+BOOST_AUTO_TEST_CASE(test_random_operations)
+{
+  const auto color = dst::binary_tree::default_marking_color;
+
+  std::mt19937 generator(3);
+
+  {
+    splay_list l;
+    std::vector<int> v;
+
+    for (int i = 0; i < 3000; ++i)
+    {
+      const auto op = generator() % 10;
+
+      if (v.size() < 20 || op < 4)
+      {
+        const auto pos = generator() % (v.size() + 1);
+
+        const auto it = l.insert(std::next(l.cbegin(), pos), i);
+        v.insert(v.begin() + pos, i);
+
+        if (i % 3 == 0)
+          l.mark(it);
+      }
+      else if (op < 7)
+      {
+        const auto pos = generator() % v.size();
+
+        l.erase(l.element_at(pos));
+        v.erase(v.begin() + pos);
+      }
+      else
+      {
+        // Skewed lookups within a small window
+        const auto pos = v.size() / 2 + generator() % 8;
+
+        BOOST_TEST_REQUIRE(l[pos] == v[pos]);
+      }
+
+      if (i % 100 == 0)
+      {
+        BOOST_TEST_REQUIRE(indexing_invariant_holds(l));
+        BOOST_TEST_REQUIRE(marking_invariant_holds(l, color));
+      }
+    }
+
+    BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+
+    for (auto it = l.begin_marked(); it != l.end_marked(); ++it)
+    {
+      BOOST_TEST(*it % 3 == 0);
+    }
+  }
+
+  BOOST_TEST(splay_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_split_and_join)
+{
+  for (int n = 0; n < 40; ++n)
+  {
+    std::vector<int> v(n);
+    std::iota(v.begin(), v.end(), 0);
+
+    for (int pos = 0; pos <= n; ++pos)
+    {
+      splay_list l(v.begin(), v.end());
+
+      auto r = l.split(std::next(l.cbegin(), pos));
+
+      BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.begin() + pos));
+      BOOST_TEST(std::equal(r.begin(), r.end(), v.begin() + pos, v.end()));
+      BOOST_TEST(indexing_invariant_holds(l));
+      BOOST_TEST(indexing_invariant_holds(r));
+
+      l.join(r);
+
+      BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+      BOOST_TEST(indexing_invariant_holds(l));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_degenerate_tree)
+{
+  {
+    // Appending splays every new element to the root and leaves a path
+    splay_list l;
+
+    for (int i = 0; i < 100000; ++i)
+    {
+      l.push_back(i);
+    }
+
+    const splay_list copy(l);
+
+    BOOST_TEST(copy.size() == l.size());
+    BOOST_TEST(std::equal(l.begin(), l.end(), copy.begin(), copy.end()));
+    BOOST_TEST(l[0] == 0);
+  }
+
+  BOOST_TEST(splay_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // dst_test
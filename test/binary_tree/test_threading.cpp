@@ -0,0 +1,206 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include "tools/avl_tree_invariant.h"
+#include "tools/indexing_tree_invariant.h"
+#include "tools/threading_tree_invariant.h"
+
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+#include <dst/binary_tree/mixin/threading.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <numeric> // std::iota
+#include <random>
+#include <utility> // std::move
+#include <vector>
+
+namespace dst_test
+{
+
+using threaded_list = dst::binary_tree::list<int,
+                                             std::allocator<int>,
+                                             dst::binary_tree::Threading,
+                                             dst::binary_tree::Indexing,
+                                             dst::binary_tree::AVL>;
+
+BOOST_AUTO_TEST_SUITE(test_binary_tree_threading)
+
+BOOST_AUTO_TEST_CASE(test_insert_and_erase)
+{
+  std::mt19937 generator(7);
+
+  threaded_list l;
+  std::vector<int> v;
+
+  BOOST_TEST(threading_invariant_holds(l));
+  BOOST_TEST((l.begin() == l.end()));
+
+  for (int i = 0; i < 2000; ++i)
+  {
+    const auto n = int(v.size());
+    const auto index = std::uniform_int_distribution<int>(0, n)(generator);
+
+    if (n > 0 && std::uniform_int_distribution<int>(0, 2)(generator) == 0)
+    {
+      const auto k = std::min(index, n - 1);
+
+      l.erase(l.element_at(k));
+      v.erase(v.begin() + k);
+    }
+    else if (index == n)
+    {
+      l.push_back(i);
+      v.push_back(i);
+    }
+    else
+    {
+      l.insert(l.element_at(index), i);
+      v.insert(v.begin() + index, i);
+    }
+
+    if (i % 100 == 0)
+    {
+      BOOST_TEST(threading_invariant_holds(l));
+      BOOST_TEST(avl_invariant_holds(l));
+    }
+  }
+
+  BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+  BOOST_TEST(std::equal(threaded_list::reverse_iterator(l.end()),
+                        threaded_list::reverse_iterator(l.begin()),
+                        v.rbegin(),
+                        v.rend()));
+  BOOST_TEST(threading_invariant_holds(l));
+
+  l.clear();
+
+  BOOST_TEST(threading_invariant_holds(l));
+  BOOST_TEST((l.begin() == l.end()));
+}
+
+BOOST_AUTO_TEST_CASE(test_copy_and_move)
+{
+  const threaded_list l = {1, 2, 3, 4, 5};
+
+  threaded_list copy = l;
+
+  BOOST_TEST(threading_invariant_holds(copy));
+  BOOST_TEST((copy == l));
+
+  threaded_list moved = std::move(copy);
+
+  BOOST_TEST(threading_invariant_holds(moved));
+  BOOST_TEST(threading_invariant_holds(copy));
+  BOOST_TEST(copy.empty());
+
+  copy = moved;
+  moved.pop_front();
+
+  BOOST_TEST(threading_invariant_holds(copy));
+  BOOST_TEST(threading_invariant_holds(moved));
+  BOOST_TEST((copy == l));
+
+  moved = std::move(copy);
+
+  BOOST_TEST(threading_invariant_holds(moved));
+  BOOST_TEST(threading_invariant_holds(copy));
+  BOOST_TEST((moved == l));
+
+  swap(moved, copy);
+
+  BOOST_TEST(threading_invariant_holds(moved));
+  BOOST_TEST(threading_invariant_holds(copy));
+  BOOST_TEST((copy == l));
+}
+
+BOOST_AUTO_TEST_CASE(test_split_and_splice)
+{
+  std::mt19937 generator(42);
+
+  std::vector<int> v(500);
+  std::iota(v.begin(), v.end(), 0);
+
+  threaded_list l(v.begin(), v.end());
+
+  BOOST_TEST(threading_invariant_holds(l));
+
+  for (int i = 0; i < 100; ++i)
+  {
+    std::uniform_int_distribution<int> distribution(0, int(v.size()));
+
+    auto a = distribution(generator);
+    auto b = distribution(generator);
+
+    if (a > b)
+      std::swap(a, b);
+
+    auto tail = l.split(std::next(l.cbegin(), b));
+    auto middle = l.split(std::next(l.cbegin(), a));
+
+    BOOST_TEST(threading_invariant_holds(l));
+    BOOST_TEST(threading_invariant_holds(middle));
+    BOOST_TEST(threading_invariant_holds(tail));
+
+    l.join(tail);
+
+    const auto c =
+      std::uniform_int_distribution<int>(0, int(l.size()))(generator);
+
+    l.splice(std::next(l.cbegin(), c), middle);
+
+    std::vector<int> cut(v.begin() + a, v.begin() + b);
+    v.erase(v.begin() + a, v.begin() + b);
+    v.insert(v.begin() + c, cut.begin(), cut.end());
+
+    BOOST_TEST(threading_invariant_holds(l));
+    BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+  }
+
+  l.erase(l.element_at(100), l.element_at(400));
+  v.erase(v.begin() + 100, v.begin() + 400);
+
+  BOOST_TEST(threading_invariant_holds(l));
+  BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+  BOOST_TEST(indexing_invariant_holds(l));
+}
+
+BOOST_AUTO_TEST_CASE(test_without_indexing)
+{
+  using list_type = dst::binary_tree::list<int,
+                                           std::allocator<int>,
+                                           dst::binary_tree::Threading,
+                                           dst::binary_tree::AVL>;
+
+  list_type l;
+
+  for (int i = 0; i < 100; ++i)
+  {
+    if (i % 2 == 0)
+      l.push_back(i);
+    else
+      l.push_front(i);
+  }
+
+  BOOST_TEST(threading_invariant_holds(l));
+  BOOST_TEST(avl_invariant_holds(l));
+
+  auto tail = l.split(std::next(l.cbegin(), 30));
+
+  BOOST_TEST(threading_invariant_holds(l));
+  BOOST_TEST(threading_invariant_holds(tail));
+
+  tail.erase(std::next(tail.cbegin(), 10), std::next(tail.cbegin(), 50));
+  tail.splice(tail.cbegin(), l);
+
+  BOOST_TEST(threading_invariant_holds(l));
+  BOOST_TEST(threading_invariant_holds(tail));
+  BOOST_TEST(tail.size() == 60);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // dst_test
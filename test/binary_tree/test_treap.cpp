@@ -0,0 +1,269 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include "tools/indexing_tree_invariant.h"
+#include "tools/marking_tree_invariant.h"
+#include "tools/treap_tree_invariant.h"
+
+#include <dst/allocator/global_counter_allocator.h>
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+#include <dst/binary_tree/mixin/marking.h>
+#include <dst/binary_tree/mixin/treap.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm> // std::max
+#include <cstddef>   // std::size_t
+#include <numeric>   // std::iota
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace dst_test
+{
+
+using treap_list = dst::binary_tree::list<int,
+                                          dst::global_counter_allocator<int>,
+                                          dst::binary_tree::Indexing,
+                                          dst::binary_tree::Marking<>,
+                                          dst::binary_tree::Treap>;
+
+namespace
+{
+std::vector<int> iota_vector(int from, int n)
+{
+  std::vector<int> v(n);
+  std::iota(v.begin(), v.end(), from);
+
+  return v;
+}
+
+bool treap_list_invariants_hold(const treap_list& l)
+{
+  return treap_invariant_holds(l) && indexing_invariant_holds(l) &&
+         marking_invariant_holds(l, dst::binary_tree::default_marking_color);
+}
+
+std::size_t height(treap_list::const_tree_iterator x)
+{
+  return !x ? 0 : 1 + std::max(height(left(x)), height(right(x)));
+}
+
+// Which children the nodes of the subtree `x` have, in preorder
+void append_shape(treap_list::const_tree_iterator x, std::vector<bool>& shape)
+{
+  shape.push_back(!!x);
+
+  if (!!x)
+  {
+    append_shape(left(x), shape);
+    append_shape(right(x), shape);
+  }
+}
+
+std::vector<bool> sequential_list_shape(int n)
+{
+  treap_list l;
+
+  for (int i = 0; i < n; ++i)
+  {
+    l.push_back(i);
+  }
+
+  std::vector<bool> shape;
+  append_shape(l.croot(), shape);
+
+  return shape;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_binary_tree_treap)
+
+BOOST_AUTO_TEST_CASE(test_build)
+{
+  for (int n = 0; n < 100; ++n)
+  {
+    const auto v = iota_vector(0, n);
+    const treap_list l(v.begin(), v.end());
+
+    BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+    BOOST_TEST(treap_list_invariants_hold(l));
+
+    const treap_list copy(l);
+
+    BOOST_TEST(treap_list_invariants_hold(copy));
+  }
+
+  BOOST_TEST(treap_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_random_insert_erase)
+{
+  std::mt19937 generator(13);
+
+  {
+    treap_list l;
+    std::vector<int> v;
+
+    for (int i = 0; i < 3000; ++i)
+    {
+      if (v.size() < 50 || generator() % 10 < 6)
+      {
+        const auto pos = generator() % (v.size() + 1);
+
+        const auto it = l.insert(std::next(l.cbegin(), pos), i);
+        v.insert(v.begin() + pos, i);
+
+        if (i % 2 == 0)
+          l.mark(it);
+      }
+      else
+      {
+        const auto pos = generator() % v.size();
+
+        l.erase(l.element_at(pos));
+        v.erase(v.begin() + pos);
+      }
+
+      if (i % 100 == 0)
+        BOOST_TEST_REQUIRE(treap_list_invariants_hold(l));
+    }
+
+    BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+    BOOST_TEST(treap_list_invariants_hold(l));
+  }
+
+  BOOST_TEST(treap_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_shape_after_erase)
+{
+  const int trials = 20000;
+  int roots_at_3 = 0;
+
+  for (int i = 0; i < trials; ++i)
+  {
+    treap_list l;
+
+    l.push_back(1);
+    l.push_back(2);
+    l.push_back(3);
+    l.erase(std::next(l.cbegin()));
+
+    BOOST_TEST_REQUIRE(treap_list_invariants_hold(l));
+
+    if (*l.croot() == 3)
+      ++roots_at_3;
+  }
+
+  // Either of the two remaining nodes is the root with probability 1/2,
+  // whatever the erased node's priority was
+  const auto frequency = double(roots_at_3) / trials;
+
+  BOOST_TEST(frequency > 0.47);
+  BOOST_TEST(frequency < 0.53);
+}
+
+BOOST_AUTO_TEST_CASE(test_sequential_insertion_depth)
+{
+  treap_list l;
+
+  for (int i = 0; i < 100000; ++i)
+  {
+    l.push_back(i);
+  }
+
+  // Expected depth is about 2.99 log2(n); sorted input must not degrade it
+  BOOST_TEST(height(l.croot()) < 100);
+  BOOST_TEST(treap_invariant_holds(l));
+}
+
+BOOST_AUTO_TEST_CASE(test_seeding_of_priorities)
+{
+  dst::binary_tree::seed_random_priorities(17);
+  const auto shape = sequential_list_shape(200);
+
+  dst::binary_tree::seed_random_priorities(17);
+  BOOST_TEST((sequential_list_shape(200) == shape));
+
+  // Threads draw priorities of their own, seeded apart
+  std::vector<bool> first_shape;
+  std::vector<bool> second_shape;
+
+  std::thread([&] { first_shape = sequential_list_shape(200); }).join();
+  std::thread([&] { second_shape = sequential_list_shape(200); }).join();
+
+  BOOST_TEST((first_shape != second_shape));
+}
+
+BOOST_AUTO_TEST_CASE(test_split_and_join)
+{
+  for (int n = 0; n < 60; ++n)
+  {
+    const auto v = iota_vector(0, n);
+
+    for (int pos = 0; pos <= n; ++pos)
+    {
+      treap_list l(v.begin(), v.end());
+
+      if (n > 0)
+        l.mark(std::next(l.cbegin(), n / 2));
+
+      auto r = l.split(std::next(l.cbegin(), pos));
+
+      BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.begin() + pos));
+      BOOST_TEST(std::equal(r.begin(), r.end(), v.begin() + pos, v.end()));
+      BOOST_TEST(treap_list_invariants_hold(l));
+      BOOST_TEST(treap_list_invariants_hold(r));
+
+      l.join(r);
+
+      BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+      BOOST_TEST(treap_list_invariants_hold(l));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_random_cut_and_paste)
+{
+  std::mt19937 generator(7);
+
+  auto v = iota_vector(0, 1000);
+  treap_list l(v.begin(), v.end());
+
+  for (int i = 0; i < 200; ++i)
+  {
+    std::uniform_int_distribution<int> distribution(0, int(v.size()));
+
+    auto a = distribution(generator);
+    auto b = distribution(generator);
+
+    if (a > b)
+      std::swap(a, b);
+
+    auto tail = l.split(std::next(l.cbegin(), b));
+    auto middle = l.split(std::next(l.cbegin(), a));
+
+    l.join(tail);
+
+    const auto c =
+      std::uniform_int_distribution<int>(0, int(l.size()))(generator);
+
+    l.splice(std::next(l.cbegin(), c), middle);
+
+    std::vector<int> cut(v.begin() + a, v.begin() + b);
+    v.erase(v.begin() + a, v.begin() + b);
+    v.insert(v.begin() + c, cut.begin(), cut.end());
+
+    BOOST_TEST_REQUIRE(treap_list_invariants_hold(l));
+  }
+
+  BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // dst_test
@@ -0,0 +1,174 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#include "tools/indexing_tree_invariant.h"
+#include "tools/wb_tree_invariant.h"
+
+#include <dst/allocator/global_counter_allocator.h>
+#include <dst/binary_tree/list.h>
+#include <dst/binary_tree/mixin/indexing.h>
+#include <dst/binary_tree/mixin/wb.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <numeric> // std::iota
+#include <random>
+#include <vector>
+
+namespace dst_test
+{
+
+using wb_list = dst::binary_tree::list<int,
+                                       dst::global_counter_allocator<int>,
+                                       dst::binary_tree::Indexing,
+                                       dst::binary_tree::WB>;
+
+namespace
+{
+std::vector<int> iota_vector(int from, int n)
+{
+  std::vector<int> v(n);
+  std::iota(v.begin(), v.end(), from);
+
+  return v;
+}
+
+bool wb_list_invariants_hold(const wb_list& l)
+{
+  return wb_invariant_holds(l) && indexing_invariant_holds(l) &&
+         l.size() == wb_list::subtree_size(l.croot());
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_binary_tree_wb)
+
+BOOST_AUTO_TEST_CASE(test_build)
+{
+  for (int n = 0; n < 100; ++n)
+  {
+    const auto v = iota_vector(0, n);
+    const wb_list l(v.begin(), v.end());
+
+    BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+    BOOST_TEST(wb_list_invariants_hold(l));
+  }
+
+  BOOST_TEST(wb_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_random_insert_erase)
+{
+  std::mt19937 generator(11);
+
+  {
+    wb_list l;
+    std::vector<int> v;
+
+    for (int i = 0; i < 3000; ++i)
+    {
+      if (v.size() < 50 || generator() % 10 < 6)
+      {
+        const auto pos = generator() % (v.size() + 1);
+
+        l.insert(std::next(l.cbegin(), pos), i);
+        v.insert(v.begin() + pos, i);
+      }
+      else
+      {
+        const auto pos = generator() % v.size();
+
+        l.erase(l.element_at(pos));
+        v.erase(v.begin() + pos);
+      }
+
+      if (i % 100 == 0)
+        BOOST_TEST_REQUIRE(wb_list_invariants_hold(l));
+    }
+
+    BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+
+    for (int i = 0; i < 1000; ++i)
+    {
+      l.push_back(i);
+    }
+
+    BOOST_TEST(wb_list_invariants_hold(l));
+
+    while (!l.empty())
+    {
+      l.pop_front();
+    }
+
+    BOOST_TEST(wb_list_invariants_hold(l));
+  }
+
+  BOOST_TEST(wb_list::allocator_type::allocated() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_split_and_join)
+{
+  for (int n = 0; n < 60; ++n)
+  {
+    const auto v = iota_vector(0, n);
+
+    for (int pos = 0; pos <= n; ++pos)
+    {
+      wb_list l(v.begin(), v.end());
+
+      auto r = l.split(std::next(l.cbegin(), pos));
+
+      BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.begin() + pos));
+      BOOST_TEST(std::equal(r.begin(), r.end(), v.begin() + pos, v.end()));
+      BOOST_TEST(wb_list_invariants_hold(l));
+      BOOST_TEST(wb_list_invariants_hold(r));
+
+      l.join(r);
+
+      BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+      BOOST_TEST(wb_list_invariants_hold(l));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_random_cut_and_paste)
+{
+  std::mt19937 generator(5);
+
+  auto v = iota_vector(0, 1000);
+  wb_list l(v.begin(), v.end());
+
+  for (int i = 0; i < 200; ++i)
+  {
+    std::uniform_int_distribution<int> distribution(0, int(v.size()));
+
+    auto a = distribution(generator);
+    auto b = distribution(generator);
+
+    if (a > b)
+      std::swap(a, b);
+
+    auto tail = l.split(std::next(l.cbegin(), b));
+    auto middle = l.split(std::next(l.cbegin(), a));
+
+    l.join(tail);
+
+    const auto c =
+      std::uniform_int_distribution<int>(0, int(l.size()))(generator);
+
+    l.splice(std::next(l.cbegin(), c), middle);
+
+    std::vector<int> cut(v.begin() + a, v.begin() + b);
+    v.erase(v.begin() + a, v.begin() + b);
+    v.insert(v.begin() + c, cut.begin(), cut.end());
+
+    BOOST_TEST_REQUIRE(wb_list_invariants_hold(l));
+  }
+
+  BOOST_TEST(std::equal(l.begin(), l.end(), v.begin(), v.end()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // dst_test
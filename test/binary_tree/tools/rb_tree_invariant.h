@@ -0,0 +1,67 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/algorithm.h>
+#include <dst/binary_tree/write_graphviz.h>
+
+#include <iostream>
+#include <vector>
+
+namespace dst_test
+{
+namespace detail
+{
+// Returns the black height of the subtree `x`, or -1 if it differs between
+// the subtrees of `x`
+template <typename Container, typename BinaryTreeIterator>
+int check_rb_subtree_invariant(std::vector<BinaryTreeIterator>& bad_nodes,
+                               BinaryTreeIterator x)
+{
+  if (!x)
+    return 1;
+
+  const auto left_height =
+    check_rb_subtree_invariant<Container>(bad_nodes, left(x));
+  const auto right_height =
+    check_rb_subtree_invariant<Container>(bad_nodes, right(x));
+
+  const bool red_child =
+    Container::is_red(left(x)) || Container::is_red(right(x));
+
+  if (left_height != right_height || (Container::is_red(x) && red_child))
+  {
+    bad_nodes.push_back(x);
+  }
+
+  return left_height + !Container::is_red(x);
+}
+} // detail
+
+template <typename Container>
+bool rb_invariant_holds(const Container& container,
+                        bool print_to_stdout = true)
+{
+  std::vector<typename Container::const_tree_iterator> bad_nodes;
+  detail::check_rb_subtree_invariant<Container>(bad_nodes, container.root());
+
+  if (Container::is_red(container.root()))
+    bad_nodes.push_back(container.root());
+
+  if (bad_nodes.size() > 0 && print_to_stdout)
+  {
+    std::cout << "Bad red-black tree:" << std::endl;
+
+    dst::binary_tree::write_graphviz(std::cout,
+                                     container.root(),
+                                     &Container::is_red,
+                                     bad_nodes.begin(),
+                                     bad_nodes.end());
+  }
+
+  return bad_nodes.size() == 0;
+}
+} // dst_test
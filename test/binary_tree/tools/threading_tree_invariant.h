@@ -0,0 +1,65 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/algorithm.h>
+
+#include <iostream>
+#include <vector>
+
+namespace dst_test
+{
+// Takes the container by reference: copying it would rebuild the threads.
+template <typename Container>
+bool threading_invariant_holds(const Container& container,
+                               bool print_to_stdout = true)
+{
+  std::vector<typename Container::const_tree_iterator> nodes;
+
+  for (auto x = minimum(container.root()); !!x; x = successor(x))
+  {
+    nodes.push_back(x);
+  }
+
+  bool forward_ok = true;
+  auto it = container.begin();
+
+  for (const auto x : nodes)
+  {
+    if (it == container.end() || it.base() != x)
+    {
+      forward_ok = false;
+      break;
+    }
+
+    ++it;
+  }
+
+  forward_ok = forward_ok && it == container.end();
+
+  bool backward_ok = true;
+  it = container.end();
+
+  for (auto rit = nodes.rbegin(); rit != nodes.rend(); ++rit)
+  {
+    if (it == container.begin() || (--it).base() != *rit)
+    {
+      backward_ok = false;
+      break;
+    }
+  }
+
+  backward_ok = backward_ok && it == container.begin();
+
+  if (print_to_stdout && !(forward_ok && backward_ok))
+  {
+    std::cout << "Bad Threading tree:" << (forward_ok ? "" : " forward")
+              << (backward_ok ? "" : " backward") << std::endl;
+  }
+
+  return forward_ok && backward_ok;
+}
+} // dst_test
@@ -0,0 +1,61 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/algorithm.h>
+#include <dst/binary_tree/write_graphviz.h>
+
+#include <iostream>
+#include <vector>
+
+namespace dst_test
+{
+namespace detail
+{
+template <typename Container, typename BinaryTreeIterator>
+void check_treap_subtree_invariant(std::vector<BinaryTreeIterator>& bad_nodes,
+                                   BinaryTreeIterator x)
+{
+  if (!x)
+    return;
+
+  for (const auto c : {left(x), right(x)})
+  {
+    if (!!c && Container::priority(x) < Container::priority(c))
+    {
+      bad_nodes.push_back(x);
+    }
+
+    check_treap_subtree_invariant<Container>(bad_nodes, c);
+  }
+}
+} // detail
+
+template <typename Container>
+bool treap_invariant_holds(const Container& container,
+                           bool print_to_stdout = true)
+{
+  std::vector<typename Container::const_tree_iterator> bad_nodes;
+  detail::check_treap_subtree_invariant<Container>(bad_nodes,
+                                                   container.root());
+
+  if (bad_nodes.size() > 0 && print_to_stdout)
+  {
+    std::cout << "Bad treap:" << std::endl;
+
+    dst::binary_tree::write_graphviz(
+      std::cout,
+      container.root(),
+      [](typename Container::const_tree_iterator x) {
+        return Container::priority(x);
+      },
+      bad_nodes.begin(),
+      bad_nodes.end());
+  }
+
+  return bad_nodes.size() == 0;
+}
+} // dst_test
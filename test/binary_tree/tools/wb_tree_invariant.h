@@ -0,0 +1,63 @@
+//          Copyright Maksym V. Bilinets 2015 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt )
+
+#pragma once
+
+#include <dst/binary_tree/algorithm.h>
+#include <dst/binary_tree/write_graphviz.h>
+
+#include <cstddef> // std::size_t
+#include <iostream>
+#include <vector>
+
+namespace dst_test
+{
+namespace detail
+{
+// Returns the weight of the subtree `x`, i.e. its size plus one
+template <typename BinaryTreeIterator>
+std::size_t
+check_wb_subtree_invariant(std::vector<BinaryTreeIterator>& bad_nodes,
+                           BinaryTreeIterator x)
+{
+  if (!x)
+    return 1;
+
+  const auto left_weight = check_wb_subtree_invariant(bad_nodes, left(x));
+  const auto right_weight = check_wb_subtree_invariant(bad_nodes, right(x));
+
+  if (3 * left_weight < right_weight || 3 * right_weight < left_weight)
+  {
+    bad_nodes.push_back(x);
+  }
+
+  return left_weight + right_weight;
+}
+} // detail
+
+template <typename Container>
+bool wb_invariant_holds(const Container& container,
+                        bool print_to_stdout = true)
+{
+  std::vector<typename Container::const_tree_iterator> bad_nodes;
+  detail::check_wb_subtree_invariant(bad_nodes, container.root());
+
+  if (bad_nodes.size() > 0 && print_to_stdout)
+  {
+    std::cout << "Bad weight-balanced tree:" << std::endl;
+
+    dst::binary_tree::write_graphviz(
+      std::cout,
+      container.root(),
+      [](typename Container::const_tree_iterator x) {
+        return Container::subtree_size(x);
+      },
+      bad_nodes.begin(),
+      bad_nodes.end());
+  }
+
+  return bad_nodes.size() == 0;
+}
+} // dst_test